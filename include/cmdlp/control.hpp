@@ -0,0 +1,176 @@
+/// @file control.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines a local control endpoint, listing and changing the live
+/// options of a running process over a Unix socket.
+
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include "detail/socket.hpp"
+#include "parser.hpp"
+
+namespace cmdlp
+{
+
+/// @class ControlServer
+/// @brief Serves requests on the live options of a parser (see `Parser::addLiveOption`).
+/// @details Each connection carries one request and one reply, both written
+/// as lists of strings (see `sendControl`). The requests are:
+///  - `list`: replies with one "name type value" entry per live option;
+///  - `get name`: replies with the value of the option;
+///  - `set name value`: converts and stores the value, and replies with it.
+///
+/// The first string of the reply is "ok" or "error", the latter followed by
+/// the reason, such as an unknown option or a value of the wrong type.
+/// Requests are served in the calling thread, typically a dedicated one,
+/// and store the values atomically, so the other threads keep reading the
+/// options through their `Live` handles. Only live options can be reached.
+/// A client that stays silent is dropped after a timeout, and malformed or
+/// oversized requests are discarded without affecting the process.
+class ControlServer {
+public:
+    /// @brief Binds the control endpoint to a Unix socket.
+    /// @param _parser The parser holding the live options.
+    /// @param _path The filesystem path of the socket, replaced if it is a stale socket.
+    /// @param _timeout The longest wait for a request once a client is connected.
+    /// @throws std::runtime_error if the socket cannot be created, or
+    /// something other than a socket exists at the path.
+    ControlServer(Parser &_parser, std::string _path, std::chrono::milliseconds _timeout = std::chrono::milliseconds(1000))
+        : parser(_parser),
+          path(std::move(_path)),
+          timeout(_timeout),
+          listen_fd(-1)
+    {
+        sockaddr_un address = detail::make_socket_address(path);
+        listen_fd           = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listen_fd < 0) {
+            throw detail::system_error("Cannot create socket");
+        }
+        try {
+            detail::remove_stale_socket(path);
+        } catch (...) {
+            ::close(listen_fd);
+            throw;
+        }
+        if ((::bind(listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) || (::listen(listen_fd, 16) < 0)) {
+            std::runtime_error error = detail::system_error("Cannot listen on " + path);
+            ::close(listen_fd);
+            throw error;
+        }
+    }
+
+    /// @brief Closes the socket and removes it from the filesystem.
+    ~ControlServer()
+    {
+        ::close(listen_fd);
+        ::unlink(path.c_str());
+    }
+
+    ControlServer(const ControlServer &)            = delete;
+    ControlServer &operator=(const ControlServer &) = delete;
+
+    /// @brief Serves requests until `stop` is called or an error occurs.
+    void serve()
+    {
+        while (this->serveOne()) {}
+    }
+
+    /// @brief Makes `serve` return, it can be called from another thread.
+    void stop()
+    {
+        ::shutdown(listen_fd, SHUT_RDWR);
+    }
+
+    /// @brief Waits for a single request and replies to it.
+    /// @return False if the endpoint could not accept connections anymore.
+    bool serveOne()
+    {
+        int client_fd = ::accept(listen_fd, nullptr, nullptr);
+        if (client_fd < 0) {
+            return errno == EINTR;
+        }
+        // Other users could otherwise change the behavior of the process.
+        uid_t uid;
+        if (!detail::peer_uid(client_fd, uid) || (uid != ::geteuid())) {
+            ::close(client_fd);
+            return true;
+        }
+        try {
+            std::vector<std::string> request;
+            if (detail::set_receive_timeout(client_fd, timeout) && detail::read_strings(client_fd, request, 16, 4096)) {
+                detail::write_strings(client_fd, this->handle(request));
+            }
+        } catch (const std::exception &) {
+            // The request is dropped, the endpoint keeps serving.
+        }
+        ::close(client_fd);
+        return true;
+    }
+
+private:
+    /// @brief Executes a request.
+    /// @param request The command and its arguments.
+    /// @return The reply.
+    std::vector<std::string> handle(const std::vector<std::string> &request)
+    {
+        try {
+            if ((request.size() == 1) && (request[0] == "list")) {
+                std::vector<std::string> reply = { "ok" };
+                for (const auto &entry : parser.getLiveOptions()) {
+                    reply.push_back(entry.first + " " + entry.second + " " + parser.getLiveValue(entry.first));
+                }
+                return reply;
+            }
+            if ((request.size() == 2) && (request[0] == "get")) {
+                return { "ok", parser.getLiveValue(request[1]) };
+            }
+            if ((request.size() == 3) && (request[0] == "set")) {
+                parser.setLiveValue(request[1], request[2]);
+                return { "ok", parser.getLiveValue(request[1]) };
+            }
+        } catch (const std::exception &error) {
+            return { "error", error.what() };
+        }
+        return { "error", "Unknown request, expected list, get <option> or set <option> <value>" };
+    }
+
+    /// @brief The parser holding the live options.
+    Parser &parser;
+    /// @brief The filesystem path of the socket.
+    std::string path;
+    /// @brief The longest wait for a request once a client is connected.
+    std::chrono::milliseconds timeout;
+    /// @brief The listening socket.
+    int listen_fd;
+};
+
+/// @brief Sends a request to a running `ControlServer`.
+/// @param path The filesystem path of the control socket.
+/// @param request The command and its arguments (e.g., `{ "set", "--log-level", "3" }`).
+/// @return The reply, starting with "ok" or "error".
+/// @throws std::runtime_error if no endpoint is listening on `path`, or the exchange fails.
+inline std::vector<std::string> sendControl(const std::string &path, const std::vector<std::string> &request)
+{
+    sockaddr_un address = detail::make_socket_address(path);
+    int fd              = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw detail::system_error("Cannot create socket");
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) {
+        std::runtime_error error = detail::system_error("Cannot connect to " + path);
+        ::close(fd);
+        throw error;
+    }
+    std::vector<std::string> reply;
+    bool exchanged = detail::write_strings(fd, request) && detail::read_strings(fd, reply);
+    ::close(fd);
+    if (!exchanged) {
+        throw std::runtime_error("Cannot exchange the request with " + path);
+    }
+    return reply;
+}
+
+} // namespace cmdlp
+
+#endif
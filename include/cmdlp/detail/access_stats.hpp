@@ -0,0 +1,160 @@
+/// @file access_stats.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the per-option access counters, enabled with `CMDLP_ACCESS_STATS`.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace cmdlp::detail
+{
+
+/// @class AccessCounters
+/// @brief Counts how many times an option is read and how many times it is set by the parser.
+/// @details Counters use relaxed atomics, so options can be read concurrently
+/// without affecting the ordering of the surrounding code. The copies of an
+/// option share its counters.
+class AccessCounters {
+public:
+    /// @brief Constructs zeroed counters.
+    AccessCounters()
+        : reads(0),
+          hits(0)
+    {
+    }
+
+    AccessCounters(const AccessCounters &) = delete;
+
+    AccessCounters &operator=(const AccessCounters &) = delete;
+
+    /// @brief Records a read of the option value.
+    inline void countRead() const
+    {
+        reads.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// @brief Records that the parser found the option on the command line.
+    inline void countHit() const
+    {
+        hits.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// @brief Returns the number of reads.
+    inline std::size_t getReads() const
+    {
+        return reads.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Returns the number of parse hits.
+    inline std::size_t getHits() const
+    {
+        return hits.load(std::memory_order_relaxed);
+    }
+
+private:
+    /// @brief The number of reads of the option value.
+    mutable std::atomic<std::size_t> reads;
+    /// @brief The number of times the option was found while parsing.
+    mutable std::atomic<std::size_t> hits;
+};
+
+/// @brief Alias for the counters of an option, under its long name.
+using access_entry_t = std::pair<std::string, std::shared_ptr<const AccessCounters>>;
+
+/// @brief Writes how many times each option was read and found on the command line.
+/// @param os The stream the report is written to.
+/// @param entries The counters of the options.
+/// @details Options are sorted by number of reads, the ones that were never
+/// read are marked as unused, even if they were given on the command line.
+inline void write_access_report(std::ostream &os, std::vector<access_entry_t> entries)
+{
+    std::stable_sort(entries.begin(), entries.end(), [](const access_entry_t &lhs, const access_entry_t &rhs) {
+        return lhs.second->getReads() > rhs.second->getReads();
+    });
+    std::size_t width = 0;
+    for (const access_entry_t &entry : entries) {
+        width = std::max(width, entry.first.length());
+    }
+    os << "cmdlp access report (" << entries.size() << " options):\n";
+    for (const access_entry_t &entry : entries) {
+        std::size_t reads = entry.second->getReads(), hits = entry.second->getHits();
+        os << "    " << std::setw(static_cast<int>(width)) << std::left << entry.first
+           << " reads: " << std::setw(8) << std::left << reads
+           << " hits: " << hits
+           << ((reads == 0) ? " (unused)" : "") << "\n";
+    }
+}
+
+/// @class AccessReport
+/// @brief Gathers the counters of the options of all the parsers, and dumps
+/// them once to `std::cerr` when the program exits.
+/// @details Parsers hand their counters over when they are destroyed. The
+/// copies of a parser share its counters, which are only reported once.
+class AccessReport {
+public:
+    /// @brief Returns the report of the process.
+    static AccessReport &instance()
+    {
+        static AccessReport report;
+        return report;
+    }
+
+    AccessReport(const AccessReport &) = delete;
+
+    AccessReport &operator=(const AccessReport &) = delete;
+
+    /// @brief Destructor, writes the report to `std::cerr`.
+    ~AccessReport()
+    {
+        if (!entries.empty()) {
+            write_access_report(std::cerr, entries);
+        }
+    }
+
+    /// @brief Adds the counters of an option, unless they were already added.
+    /// @param name The long name of the option.
+    /// @param counters The counters of the option.
+    void collect(const std::string &name, const std::shared_ptr<const AccessCounters> &counters)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (collected.insert(counters.get()).second) {
+            entries.emplace_back(name, counters);
+        }
+    }
+
+    /// @brief Writes the counters collected so far.
+    /// @param os The stream the report is written to.
+    void write(std::ostream &os) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        write_access_report(os, entries);
+    }
+
+private:
+    /// @brief Constructs an empty report.
+    AccessReport()
+        : mutex(),
+          entries(),
+          collected()
+    {
+    }
+
+    /// @brief Guards the collected counters, parsers can be destroyed by any thread.
+    mutable std::mutex mutex;
+    /// @brief The collected counters, in collection order.
+    std::vector<access_entry_t> entries;
+    /// @brief The counters already collected.
+    std::unordered_set<const AccessCounters *> collected;
+};
+
+} // namespace cmdlp::detail
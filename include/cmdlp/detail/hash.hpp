@@ -0,0 +1,42 @@
+/// @file hash.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the hash function used to fingerprint options and arguments.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace cmdlp::detail
+{
+
+/// @brief The initial value of a FNV-1a hash.
+constexpr uint64_t fnv1a_basis = 14695981039346656037ULL;
+
+/// @brief Feeds a sequence of bytes to a 64-bit FNV-1a hash.
+/// @param data The bytes to hash.
+/// @param size The number of bytes.
+/// @param hash The current value of the hash.
+/// @return The updated hash.
+inline uint64_t fnv1a(const void *data, std::size_t size, uint64_t hash = fnv1a_basis)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/// @brief Feeds a string to a 64-bit FNV-1a hash, terminator included.
+/// @param str The string to hash.
+/// @param hash The current value of the hash.
+/// @return The updated hash.
+/// @details Hashing the terminator keeps `{"ab", "c"}` and `{"a", "bc"}` apart.
+inline uint64_t fnv1a(const std::string &str, uint64_t hash = fnv1a_basis)
+{
+    return fnv1a(str.c_str(), str.size() + 1, hash);
+}
+
+} // namespace cmdlp::detail
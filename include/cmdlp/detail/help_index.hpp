@@ -0,0 +1,130 @@
+/// @file help_index.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the inverted index used to search the help by keyword.
+
+#pragma once
+
+#include "memory_usage.hpp"
+#include "option_list.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace cmdlp::detail
+{
+
+/// @class HelpIndex
+/// @brief Maps each word of the option names and descriptions to the options containing it.
+/// @details Words are maximal runs of letters and digits, compared without
+/// regard to case, so "--db.pool-size" holds "db", "pool" and "size".
+class HelpIndex {
+public:
+    /// @brief Alias for the slots of the options containing a word, in slot order.
+    using slot_list_t = std::vector<std::size_t>;
+
+    /// @brief Constructs an empty index.
+    HelpIndex()
+        : words(),
+          built(false)
+    {
+    }
+
+    /// @brief Tells whether the index has not been built yet.
+    inline bool empty() const
+    {
+        return !built;
+    }
+
+    /// @brief Removes all the words, so that the index is built again.
+    inline void clear()
+    {
+        words.clear();
+        built = false;
+    }
+
+    /// @brief Indexes the names and the descriptions of all the options.
+    /// @param options The options, separators are skipped.
+    void build(const OptionList &options)
+    {
+        words.clear();
+        for (std::size_t slot = 0; slot < options.size(); ++slot) {
+            const Option *option = options.getOptionAt(slot);
+            if (dynamic_cast<const Separator *>(option)) {
+                continue;
+            }
+            for (const std::string *text : { &option->opt_short, &option->opt_long, &option->description }) {
+                HelpIndex::splitWords(*text, [&](std::string word) {
+                    slot_list_t &slots = words[std::move(word)];
+                    if (slots.empty() || (slots.back() != slot)) {
+                        slots.push_back(slot);
+                    }
+                });
+            }
+        }
+        built = true;
+    }
+
+    /// @brief Finds the options containing all the words of a query.
+    /// @param query One or more words.
+    /// @return The slots of the matching options, in slot order.
+    slot_list_t search(std::string_view query) const
+    {
+        slot_list_t result, intersection;
+        bool first = true;
+        HelpIndex::splitWords(query, [&](const std::string &word) {
+            auto it = words.find(word);
+            if (it == words.end()) {
+                result.clear();
+            } else if (first) {
+                result = it->second;
+            } else {
+                intersection.clear();
+                std::set_intersection(result.begin(), result.end(), it->second.begin(), it->second.end(), std::back_inserter(intersection));
+                result.swap(intersection);
+            }
+            first = false;
+        });
+        return result;
+    }
+
+    /// @brief Adds the memory used by the index to the given report.
+    /// @param usage The report to update.
+    void getMemoryUsage(MemoryUsage &usage) const
+    {
+        usage.indices += heap_size(words);
+        for (const auto &entry : words) {
+            usage.indices += entry.second.capacity() * sizeof(std::size_t);
+        }
+    }
+
+private:
+    /// @brief Splits a text into lowercase words.
+    /// @tparam Function A callable accepting a `std::string`.
+    /// @param text The text.
+    /// @param function Called once per word, in order.
+    template <typename Function>
+    static void splitWords(std::string_view text, Function function)
+    {
+        std::string word;
+        for (std::size_t i = 0; i <= text.size(); ++i) {
+            if ((i < text.size()) && std::isalnum(static_cast<unsigned char>(text[i]))) {
+                word.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(text[i]))));
+            } else if (!word.empty()) {
+                function(std::move(word));
+                word.clear();
+            }
+        }
+    }
+
+    /// @brief Maps each word to the options containing it.
+    std::unordered_map<std::string, slot_list_t> words;
+    /// @brief Whether the index has been built, even if no word was found.
+    bool built;
+};
+
+} // namespace cmdlp::detail
@@ -0,0 +1,75 @@
+/// @file memory_usage.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the structure used to report the memory footprint of the parser.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cmdlp::detail
+{
+
+/// @struct MemoryUsage
+/// @brief The bytes used by the parser, broken down by category.
+/// @details Heap sizes are estimated from the capacity of the containers, the
+/// bookkeeping of the allocator itself is not included.
+struct MemoryUsage {
+    /// @brief The option objects themselves, and the list holding them.
+    std::size_t schema = 0;
+    /// @brief The heap storage of the short and long names.
+    std::size_t names = 0;
+    /// @brief The heap storage of the descriptions.
+    std::size_t descriptions = 0;
+    /// @brief The heap storage of the values, allowed values and arguments.
+    std::size_t values = 0;
+    /// @brief The lookup tables of the options and of the arguments.
+    std::size_t indices = 0;
+
+    /// @brief Returns the sum of all categories.
+    inline std::size_t total() const
+    {
+        return schema + names + descriptions + values + indices;
+    }
+};
+
+/// @brief Returns the heap bytes owned by a string.
+/// @param str The string.
+/// @return Zero if the string fits in the small-string buffer, its capacity otherwise.
+inline std::size_t heap_size(const std::string &str)
+{
+    static const std::size_t sso_capacity = std::string().capacity();
+    return (str.capacity() > sso_capacity) ? (str.capacity() + 1) : 0;
+}
+
+/// @brief Returns the heap bytes owned by a vector of strings, strings included.
+/// @param vec The vector.
+/// @return The size of the vector buffer plus the heap bytes of each string.
+inline std::size_t heap_size(const std::vector<std::string> &vec)
+{
+    std::size_t size = vec.capacity() * sizeof(std::string);
+    for (const std::string &str : vec) {
+        size += heap_size(str);
+    }
+    return size;
+}
+
+/// @brief Returns the heap bytes owned by a hash table with string keys.
+/// @tparam Value The type of the mapped values.
+/// @param map The hash table.
+/// @return An estimate of the buckets, the nodes and the heap of the keys.
+template <typename Value>
+inline std::size_t heap_size(const std::unordered_map<std::string, Value> &map)
+{
+    // Each node holds the next pointer, the cached hash and the key-value pair.
+    const std::size_t node_size = sizeof(void *) + sizeof(std::size_t) + sizeof(typename std::unordered_map<std::string, Value>::value_type);
+    std::size_t size            = map.bucket_count() * sizeof(void *) + map.size() * node_size;
+    for (const auto &entry : map) {
+        size += heap_size(entry.first);
+    }
+    return size;
+}
+
+} // namespace cmdlp::detail
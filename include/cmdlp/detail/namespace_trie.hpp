@@ -0,0 +1,135 @@
+/// @file namespace_trie.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the trie indexing dotted option names (e.g., "--db.pool.size") by segment.
+
+#pragma once
+
+#include "memory_usage.hpp"
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace cmdlp::detail
+{
+
+/// @class NamespaceTrie
+/// @brief Maps each segment of a dotted name to the namespaces and options below it.
+/// @details Names are stored without their leading dashes, so "--db.pool.size"
+/// is reached through "db", "pool" and "size". Resolving a namespace costs one
+/// lookup per segment, and enumerating it only visits its own subtree.
+class NamespaceTrie {
+public:
+    /// @brief The value returned when a namespace or a slot cannot be found.
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /// @brief Constructs a trie holding only the root namespace.
+    NamespaceTrie()
+        : nodes(1)
+    {
+    }
+
+    /// @brief Tells whether a name is dotted, and thus belongs to a namespace.
+    /// @param name The long name of an option.
+    /// @return True if the name contains a dot after its leading dashes.
+    static inline bool isDotted(std::string_view name)
+    {
+        return NamespaceTrie::trim(name).find('.') != std::string_view::npos;
+    }
+
+    /// @brief Adds an option under its dotted name.
+    /// @param name The long name of the option, with or without leading dashes.
+    /// @param slot The slot of the option.
+    void insert(std::string_view name, std::size_t slot)
+    {
+        std::size_t node = 0;
+        name             = NamespaceTrie::trim(name);
+        while (!name.empty()) {
+            std::size_t dot = name.find('.');
+            auto result     = nodes[node].children.emplace(std::string(name.substr(0, dot)), nodes.size());
+            node            = result.first->second;
+            // Add the node last, as it may move the children of its parent.
+            if (result.second) {
+                nodes.emplace_back();
+            }
+            name = (dot == std::string_view::npos) ? std::string_view() : name.substr(dot + 1);
+        }
+        nodes[node].slot = slot;
+    }
+
+    /// @brief Collects the slots of the options below a namespace.
+    /// @param prefix The namespace (e.g., "db.pool"), with or without leading dashes.
+    /// @param slots The vector the slots are appended to, in no particular order.
+    /// @details A prefix naming an option, rather than a namespace, yields that option.
+    void collect(std::string_view prefix, std::vector<std::size_t> &slots) const
+    {
+        std::size_t node = this->find(prefix);
+        if (node == npos) {
+            return;
+        }
+        std::vector<std::size_t> pending(1, node);
+        while (!pending.empty()) {
+            node = pending.back();
+            pending.pop_back();
+            if (nodes[node].slot != npos) {
+                slots.push_back(nodes[node].slot);
+            }
+            for (const auto &child : nodes[node].children) {
+                pending.push_back(child.second);
+            }
+        }
+    }
+
+    /// @brief Adds the memory used by the trie to the given report.
+    /// @param usage The report to update.
+    void getMemoryUsage(MemoryUsage &usage) const
+    {
+        usage.indices += nodes.capacity() * sizeof(Node);
+        for (const Node &node : nodes) {
+            usage.indices += heap_size(node.children);
+        }
+    }
+
+private:
+    /// @brief A namespace, or an option, identified by the path from the root.
+    struct Node {
+        /// @brief Maps the next segment to its node.
+        std::unordered_map<std::string, std::size_t> children;
+        /// @brief The slot of the option with this exact name, `npos` if none.
+        std::size_t slot = npos;
+    };
+
+    /// @brief Removes the leading dashes of a name.
+    /// @param name The name.
+    /// @return The name without leading dashes.
+    static inline std::string_view trim(std::string_view name)
+    {
+        std::size_t first = name.find_first_not_of('-');
+        return (first == std::string_view::npos) ? std::string_view() : name.substr(first);
+    }
+
+    /// @brief Resolves a namespace, one segment at a time.
+    /// @param prefix The namespace, with or without leading dashes.
+    /// @return The node of the namespace, or `npos` if it does not exist.
+    std::size_t find(std::string_view prefix) const
+    {
+        std::size_t node = 0;
+        prefix           = NamespaceTrie::trim(prefix);
+        while (!prefix.empty()) {
+            std::size_t dot = prefix.find('.');
+            auto it         = nodes[node].children.find(std::string(prefix.substr(0, dot)));
+            if (it == nodes[node].children.end()) {
+                return npos;
+            }
+            node   = it->second;
+            prefix = (dot == std::string_view::npos) ? std::string_view() : prefix.substr(dot + 1);
+        }
+        return node;
+    }
+
+    /// @brief The nodes, the root namespace first.
+    std::vector<Node> nodes;
+};
+
+} // namespace cmdlp::detail
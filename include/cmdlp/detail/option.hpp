@@ -4,9 +4,38 @@
 
 #pragma once
 
+#ifdef CMDLP_ACCESS_STATS
+#include "access_stats.hpp"
+#endif
+
+#include "memory_usage.hpp"
+#include "value_file.hpp"
+
+#include "../value_traits.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
 #include <stdexcept>
 #include <sstream>
 #include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cmdlp
+{
+
+/// @brief The visibility of an option in the help, each tier also shows the ones before it.
+enum class HelpTier {
+    basic,    ///< Shown in the default help.
+    advanced, ///< Shown when the advanced help is requested.
+    hidden    ///< Only shown when the complete help is requested.
+};
+
+} // namespace cmdlp
 
 namespace cmdlp::detail
 {
@@ -21,6 +50,12 @@ public:
     const std::string opt_long;
     /// @brief A description of the option, typically used in help messages.
     const std::string description;
+    /// @brief The tier of the help in which the option is shown.
+    HelpTier tier;
+#ifdef CMDLP_ACCESS_STATS
+    /// @brief Counts the reads and the parse hits of the option, shared by its copies.
+    std::shared_ptr<const AccessCounters> stats;
+#endif
 
     /// @brief Constructs an `Option` object.
     /// @param _opt_short The short version of the option.
@@ -29,9 +64,28 @@ public:
     Option(std::string _opt_short, std::string _opt_long, std::string _description)
         : opt_short(std::move(_opt_short)),
           opt_long(std::move(_opt_long)),
-          description(std::move(_description))
+          description(std::move(_description)),
+          tier(HelpTier::basic)
     {
-        // Constructor logic (currently empty).
+#ifdef CMDLP_ACCESS_STATS
+        stats = std::make_shared<const AccessCounters>();
+#endif
+    }
+
+    /// @brief Constructs a copy of an `Option` object under different names.
+    /// @param other The option to copy.
+    /// @param _opt_short The new short version of the option.
+    /// @param _opt_long The new long version of the option.
+    Option(const Option &other, std::string _opt_short, std::string _opt_long)
+        : opt_short(std::move(_opt_short)),
+          opt_long(std::move(_opt_long)),
+          description(other.description),
+          tier(other.tier)
+    {
+        // A renamed copy is another option, with its own counters.
+#ifdef CMDLP_ACCESS_STATS
+        stats = std::make_shared<const AccessCounters>();
+#endif
     }
 
     /// @brief Virtual destructor.
@@ -41,6 +95,46 @@ public:
     /// @return The length of the value as a `std::size_t`.
     /// @details This method is pure virtual and must be implemented by derived classes.
     virtual std::size_t get_value_length() const = 0;
+
+    /// @brief Tells whether the option is followed by a value on the command line.
+    /// @return True for options holding a value, false for flags and separators.
+    virtual bool takes_value() const
+    {
+        return false;
+    }
+
+    /// @brief Creates a copy of the option.
+    /// @return A new option of the same type, owned by the caller.
+    virtual Option *clone() const = 0;
+
+    /// @brief Creates a copy of the option under different names.
+    /// @param _opt_short The short version of the copy, can be empty.
+    /// @param _opt_long The long version of the copy.
+    /// @return A new option of the same type, owned by the caller.
+    virtual Option *clone_as(std::string _opt_short, std::string _opt_long) const = 0;
+
+    /// @brief Restores the value the option had when it was registered.
+    virtual void reset_value()
+    {
+        // Nothing to restore by default.
+    }
+
+    /// @brief Adds the memory used by the option to the given report.
+    /// @param usage The report to update.
+    virtual void get_memory_usage(MemoryUsage &usage) const
+    {
+        usage.schema += sizeof(Option);
+        this->get_text_memory_usage(usage);
+    }
+
+protected:
+    /// @brief Adds the heap memory of the names and of the description to the given report.
+    /// @param usage The report to update.
+    void get_text_memory_usage(MemoryUsage &usage) const
+    {
+        usage.names += heap_size(opt_short) + heap_size(opt_long);
+        usage.descriptions += heap_size(description);
+    }
 };
 
 /// @class ToggleOption
@@ -49,6 +143,8 @@ class ToggleOption : public Option {
 public:
     /// @brief Indicates whether the toggle is enabled or disabled.
     bool toggled;
+    /// @brief The initial state of the toggle.
+    const bool default_toggled;
 
     /// @brief Constructs a `ToggleOption` object.
     /// @param _opt_short The short version of the option (e.g., "-v").
@@ -57,11 +153,23 @@ public:
     /// @param _toggled The initial state of the toggle (true = enabled, false = disabled).
     ToggleOption(std::string _opt_short, std::string _opt_long, std::string _description, bool _toggled)
         : Option(std::move(_opt_short), std::move(_opt_long), std::move(_description)),
-          toggled(_toggled)
+          toggled(_toggled),
+          default_toggled(_toggled)
     {
         // Constructor logic (currently empty).
     }
 
+    /// @brief Constructs a copy of a `ToggleOption` object under different names.
+    /// @param other The option to copy.
+    /// @param _opt_short The new short version of the option.
+    /// @param _opt_long The new long version of the option.
+    ToggleOption(const ToggleOption &other, std::string _opt_short, std::string _opt_long)
+        : Option(other, std::move(_opt_short), std::move(_opt_long)),
+          toggled(other.toggled),
+          default_toggled(other.default_toggled)
+    {
+    }
+
     /// @brief Virtual destructor.
     virtual ~ToggleOption() = default;
 
@@ -71,16 +179,48 @@ public:
     {
         return 5; // Length of the string "false" or "true".
     }
+
+    virtual Option *clone() const override
+    {
+        return new ToggleOption(*this);
+    }
+
+    virtual Option *clone_as(std::string _opt_short, std::string _opt_long) const override
+    {
+        return new ToggleOption(*this, std::move(_opt_short), std::move(_opt_long));
+    }
+
+    virtual void reset_value() override
+    {
+        toggled = default_toggled;
+    }
+
+    virtual void get_memory_usage(MemoryUsage &usage) const override
+    {
+        usage.schema += sizeof(ToggleOption);
+        this->get_text_memory_usage(usage);
+    }
 };
 
 /// @class ValueOption
 /// @brief A command-line option that requires an associated value.
 class ValueOption : public Option {
 public:
+    /// @brief Alias for the function telling whether a text is a valid value for the option.
+    using validator_t = bool (*)(std::string_view);
+    /// @brief Alias for the function telling whether two texts hold the same value of the option type.
+    using comparator_t = bool (*)(std::string_view, std::string_view);
+
     /// @brief The value associated with the option.
     std::string value;
+    /// @brief The default value for the option.
+    const std::string default_value;
     /// @brief Indicates whether the option is required.
     bool required;
+    /// @brief Validates the values found on the command line, `nullptr` if any text is valid.
+    validator_t validator;
+    /// @brief Compares two values as the option type, `nullptr` to compare them as text.
+    comparator_t comparator;
 
     /// @brief Constructs a `ValueOption` object.
     /// @param _opt_short The short version of the option (e.g., "-f").
@@ -88,14 +228,47 @@ public:
     /// @param _description The description of the option.
     /// @param _value The default value for the option.
     /// @param _required Indicates whether the option is mandatory (true = required).
-    ValueOption(std::string _opt_short, std::string _opt_long, std::string _description, std::string _value, bool _required)
+    /// @param _validator Validates the values found on the command line, `nullptr` if any text is valid.
+    /// @param _comparator Compares two values as the option type, `nullptr` to compare them as text.
+    ValueOption(std::string _opt_short,
+                std::string _opt_long,
+                std::string _description,
+                std::string _value,
+                bool _required,
+                validator_t _validator   = nullptr,
+                comparator_t _comparator = nullptr)
         : Option(std::move(_opt_short), std::move(_opt_long), std::move(_description)),
-          value(std::move(_value)),
-          required(_required)
+          value(_value),
+          default_value(std::move(_value)),
+          required(_required),
+          validator(_validator),
+          comparator(_comparator)
     {
         // Constructor logic (currently empty).
     }
 
+    /// @brief Constructs a copy of a `ValueOption` object under different names.
+    /// @param other The option to copy.
+    /// @param _opt_short The new short version of the option.
+    /// @param _opt_long The new long version of the option.
+    ValueOption(const ValueOption &other, std::string _opt_short, std::string _opt_long)
+        : Option(other, std::move(_opt_short), std::move(_opt_long)),
+          value(other.value),
+          default_value(other.default_value),
+          required(other.required),
+          validator(other.validator),
+          comparator(other.comparator)
+    {
+    }
+
+    /// @brief Tells whether a text holds the same value as the current one.
+    /// @param text The text.
+    /// @return True if the values are equal, compared as the option type.
+    inline bool holds(std::string_view text) const
+    {
+        return comparator ? comparator(text, value) : (text == value);
+    }
+
     /// @brief Virtual destructor.
     virtual ~ValueOption() = default;
 
@@ -105,16 +278,49 @@ public:
     {
         return value.size();
     }
+
+    virtual bool takes_value() const override
+    {
+        return true;
+    }
+
+    virtual Option *clone() const override
+    {
+        return new ValueOption(*this);
+    }
+
+    virtual Option *clone_as(std::string _opt_short, std::string _opt_long) const override
+    {
+        return new ValueOption(*this, std::move(_opt_short), std::move(_opt_long));
+    }
+
+    virtual void reset_value() override
+    {
+        value = default_value;
+    }
+
+    virtual void get_memory_usage(MemoryUsage &usage) const override
+    {
+        usage.schema += sizeof(ValueOption);
+        this->get_text_memory_usage(usage);
+        usage.values += heap_size(value) + heap_size(default_value);
+    }
 };
 
 /// @class MultiOption
 /// @brief A command-line option that allows selecting from a predefined set of values.
+/// @details The allowed values are either given when the option is created, or
+/// listed in a file that is only read when a value is selected (see `ValueFile`).
 class MultiOption : public Option {
 public:
-    /// @brief The set of allowed values for this option.
+    /// @brief The set of allowed values for this option, empty if they are listed in a file.
     const std::vector<std::string> allowed_values;
+    /// @brief The file listing the allowed values, shared by the copies of the option.
+    const std::shared_ptr<ValueFile> value_file;
     /// @brief The selected value for this option.
     std::string selected_value;
+    /// @brief The default value for this option.
+    const std::string default_value;
 
     /// @brief Constructs a `MultiOption` object.
     /// @param _opt_short The short version of the option (e.g., "-m").
@@ -125,7 +331,9 @@ public:
     MultiOption(std::string _opt_short, std::string _opt_long, std::string _description, std::vector<std::string> _allowed_values, std::string _default_value)
         : Option(std::move(_opt_short), std::move(_opt_long), std::move(_description)),
           allowed_values(std::move(_allowed_values)),
-          selected_value(std::move(_default_value))
+          value_file(),
+          selected_value(_default_value),
+          default_value(std::move(_default_value))
     {
         if (!this->isValueAllowed(selected_value)) {
             std::ostringstream oss;
@@ -134,6 +342,36 @@ public:
         }
     }
 
+    /// @brief Constructs a `MultiOption` object whose allowed values are listed in a file.
+    /// @param _opt_short The short version of the option (e.g., "-m").
+    /// @param _opt_long The long version of the option (e.g., "--model").
+    /// @param _description The description of the option.
+    /// @param _value_file The file listing the allowed values, one per line.
+    /// @param _default_value The default value for the option.
+    /// @details The default value is not checked, so that the file is not read
+    /// unless a value is selected.
+    MultiOption(std::string _opt_short, std::string _opt_long, std::string _description, std::shared_ptr<ValueFile> _value_file, std::string _default_value)
+        : Option(std::move(_opt_short), std::move(_opt_long), std::move(_description)),
+          allowed_values(),
+          value_file(std::move(_value_file)),
+          selected_value(_default_value),
+          default_value(std::move(_default_value))
+    {
+    }
+
+    /// @brief Constructs a copy of a `MultiOption` object under different names.
+    /// @param other The option to copy.
+    /// @param _opt_short The new short version of the option.
+    /// @param _opt_long The new long version of the option.
+    MultiOption(const MultiOption &other, std::string _opt_short, std::string _opt_long)
+        : Option(other, std::move(_opt_short), std::move(_opt_long)),
+          allowed_values(other.allowed_values),
+          value_file(other.value_file),
+          selected_value(other.selected_value),
+          default_value(other.default_value)
+    {
+    }
+
     /// @brief Virtual destructor.
     virtual ~MultiOption() = default;
 
@@ -154,7 +392,8 @@ public:
     /// @return The length of the selected value as a `std::size_t`.
     virtual std::size_t get_value_length() const override
     {
-        std::size_t max_length = 0;
+        // Values listed in a file are not read just to lay out the help.
+        std::size_t max_length = value_file ? default_value.size() : 0;
         for (const auto &value : allowed_values) {
             if (value.size() > max_length) {
                 max_length = value.size();
@@ -163,11 +402,45 @@ public:
         return max_length;
     }
 
+    virtual bool takes_value() const override
+    {
+        return true;
+    }
+
+    virtual Option *clone() const override
+    {
+        return new MultiOption(*this);
+    }
+
+    virtual Option *clone_as(std::string _opt_short, std::string _opt_long) const override
+    {
+        return new MultiOption(*this, std::move(_opt_short), std::move(_opt_long));
+    }
+
+    virtual void reset_value() override
+    {
+        selected_value = default_value;
+    }
+
+    virtual void get_memory_usage(MemoryUsage &usage) const override
+    {
+        usage.schema += sizeof(MultiOption);
+        this->get_text_memory_usage(usage);
+        usage.values += heap_size(allowed_values) + heap_size(selected_value) + heap_size(default_value);
+        if (value_file) {
+            value_file->getMemoryUsage(usage);
+        }
+    }
+
     /// @brief Prints the list of allowed values.
-    /// @return A formatted string containing all allowed values.
+    /// @return A formatted string containing all allowed values, or the file listing them.
     std::string print_list() const
     {
         std::ostringstream oss;
+        if (value_file) {
+            oss << "[listed in " << value_file->getPath() << "]";
+            return oss.str();
+        }
         oss << "[";
         for (size_t i = 0; i < allowed_values.size(); ++i) {
             oss << allowed_values[i];
@@ -179,14 +452,540 @@ public:
         return oss.str();
     }
 
-private:
     /// @brief Checks if a value is allowed.
     /// @param value The value to check.
     /// @return True if the value is in the allowed values, false otherwise.
+    /// @throws std::runtime_error if the file listing the values cannot be read.
     bool isValueAllowed(const std::string &value) const
     {
+        if (value_file) {
+            return value_file->contains(value);
+        }
         return std::find(allowed_values.begin(), allowed_values.end(), value) != allowed_values.end();
     }
+
+    /// @brief Finds the allowed values starting with a prefix, to complete a partial value.
+    /// @param prefix The prefix.
+    /// @return The matching values, sorted.
+    /// @throws std::runtime_error if the file listing the values cannot be read.
+    std::vector<std::string> complete(std::string_view prefix) const
+    {
+        std::vector<std::string> result;
+        if (value_file) {
+            for (std::string_view value : value_file->complete(prefix)) {
+                result.emplace_back(value);
+            }
+            return result;
+        }
+        for (const std::string &value : allowed_values) {
+            if (std::string_view(value).substr(0, prefix.size()) == prefix) {
+                result.push_back(value);
+            }
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+};
+
+/// @class ProfileOption
+/// @brief A command-line option that selects a named bundle of option values.
+/// @details The values of each profile are validated and converted when the
+/// profile is registered; selecting a profile copies them into their options.
+class ProfileOption : public Option {
+public:
+    /// @brief A value assigned by a profile.
+    struct Setting {
+        /// @brief The slot of the option in the option list.
+        std::size_t slot;
+        /// @brief The value, for options holding a value.
+        std::string value;
+        /// @brief The state, for toggles.
+        bool toggled;
+    };
+
+    /// @brief A named bundle of values.
+    struct Profile {
+        /// @brief The name used to select the profile.
+        std::string name;
+        /// @brief The values assigned by the profile.
+        std::vector<Setting> settings;
+    };
+
+    /// @brief The registered profiles.
+    std::vector<Profile> profiles;
+    /// @brief The name of the selected profile, empty if none.
+    std::string selected_profile;
+
+    /// @brief Constructs a `ProfileOption` object.
+    /// @param _opt_short The short version of the option (e.g., "-p").
+    /// @param _opt_long The long version of the option (e.g., "--profile").
+    /// @param _description The description of the option.
+    ProfileOption(std::string _opt_short, std::string _opt_long, std::string _description)
+        : Option(std::move(_opt_short), std::move(_opt_long), std::move(_description)),
+          profiles(),
+          selected_profile()
+    {
+    }
+
+    /// @brief Constructs a copy of a `ProfileOption` object under different names.
+    /// @param other The option to copy.
+    /// @param _opt_short The new short version of the option.
+    /// @param _opt_long The new long version of the option.
+    ProfileOption(const ProfileOption &other, std::string _opt_short, std::string _opt_long)
+        : Option(other, std::move(_opt_short), std::move(_opt_long)),
+          profiles(other.profiles),
+          selected_profile(other.selected_profile)
+    {
+    }
+
+    /// @brief Virtual destructor.
+    virtual ~ProfileOption() = default;
+
+    /// @brief Finds a profile by name.
+    /// @param name The name of the profile.
+    /// @return The profile, or `nullptr` if not found.
+    const Profile *findProfile(const std::string &name) const
+    {
+        for (const Profile &profile : profiles) {
+            if (profile.name == name) {
+                return &profile;
+            }
+        }
+        return nullptr;
+    }
+
+    /// @brief Retrieves the length of the longest profile name.
+    /// @return The length of the longest profile name as a `std::size_t`.
+    virtual std::size_t get_value_length() const override
+    {
+        std::size_t max_length = 0;
+        for (const Profile &profile : profiles) {
+            max_length = std::max(max_length, profile.name.size());
+        }
+        return max_length;
+    }
+
+    virtual bool takes_value() const override
+    {
+        return true;
+    }
+
+    virtual Option *clone() const override
+    {
+        return new ProfileOption(*this);
+    }
+
+    virtual Option *clone_as(std::string _opt_short, std::string _opt_long) const override
+    {
+        return new ProfileOption(*this, std::move(_opt_short), std::move(_opt_long));
+    }
+
+    virtual void reset_value() override
+    {
+        selected_profile.clear();
+    }
+
+    virtual void get_memory_usage(MemoryUsage &usage) const override
+    {
+        usage.schema += sizeof(ProfileOption);
+        this->get_text_memory_usage(usage);
+        usage.values += profiles.capacity() * sizeof(Profile) + heap_size(selected_profile);
+        for (const Profile &profile : profiles) {
+            usage.values += heap_size(profile.name) + profile.settings.capacity() * sizeof(Setting);
+            for (const Setting &setting : profile.settings) {
+                usage.values += heap_size(setting.value);
+            }
+        }
+    }
+
+    /// @brief Prints the list of profiles.
+    /// @return A formatted string containing all profile names.
+    std::string print_list() const
+    {
+        std::ostringstream oss;
+        oss << "[";
+        for (size_t i = 0; i < profiles.size(); ++i) {
+            oss << profiles[i].name;
+            if (i < profiles.size() - 1) {
+                oss << ", ";
+            }
+        }
+        oss << "]";
+        return oss.str();
+    }
+};
+
+/// @class CompositeOption
+/// @brief A command-line option holding delimited tuples (e.g., "host:port:weight"), collected from every occurrence.
+/// @details Each occurrence is split and converted once, while parsing, and
+/// appended to the typed storage of the derived `TupleOption`.
+class CompositeOption : public Option {
+public:
+    /// @brief The character separating the elements of a tuple.
+    const char delimiter;
+
+    /// @brief Constructs a `CompositeOption` object.
+    /// @param _opt_short The short version of the option (e.g., "-e").
+    /// @param _opt_long The long version of the option (e.g., "--endpoint").
+    /// @param _description The description of the option.
+    /// @param _delimiter The character separating the elements of a tuple.
+    CompositeOption(std::string _opt_short, std::string _opt_long, std::string _description, char _delimiter)
+        : Option(std::move(_opt_short), std::move(_opt_long), std::move(_description)),
+          delimiter(_delimiter)
+    {
+    }
+
+    /// @brief Constructs a copy of a `CompositeOption` object under different names.
+    /// @param other The option to copy.
+    /// @param _opt_short The new short version of the option.
+    /// @param _opt_long The new long version of the option.
+    CompositeOption(const CompositeOption &other, std::string _opt_short, std::string _opt_long)
+        : Option(other, std::move(_opt_short), std::move(_opt_long)),
+          delimiter(other.delimiter)
+    {
+    }
+
+    /// @brief Virtual destructor.
+    virtual ~CompositeOption() = default;
+
+    /// @brief Splits and converts a tuple, and appends it to the collected ones.
+    /// @param text The text of the tuple.
+    /// @return False if the text does not hold a valid tuple, in which case nothing is appended.
+    virtual bool append(std::string_view text) = 0;
+
+    /// @brief Tells whether a text holds a valid tuple, without appending it.
+    virtual bool accepts(std::string_view text) const = 0;
+
+    /// @brief Returns the number of collected tuples.
+    virtual std::size_t count() const = 0;
+
+    /// @brief Formats the collected tuples, separated by commas.
+    virtual std::string format_values() const = 0;
+
+    virtual std::size_t get_value_length() const override
+    {
+        return 0;
+    }
+
+    virtual bool takes_value() const override
+    {
+        return true;
+    }
+};
+
+/// @class TupleOption
+/// @brief A `CompositeOption` converting its tuples to the given element types.
+/// @tparam Ts The types of the elements, converted by `value_traits`.
+template <typename... Ts>
+class TupleOption : public CompositeOption {
+public:
+    /// @brief Alias for a converted tuple.
+    using tuple_t = std::tuple<Ts...>;
+
+    /// @brief The collected tuples, in the order they appear on the command line.
+    std::vector<tuple_t> values;
+
+    /// @brief Constructs a `TupleOption` object.
+    /// @param _opt_short The short version of the option (e.g., "-e").
+    /// @param _opt_long The long version of the option (e.g., "--endpoint").
+    /// @param _description The description of the option.
+    /// @param _delimiter The character separating the elements of a tuple.
+    TupleOption(std::string _opt_short, std::string _opt_long, std::string _description, char _delimiter)
+        : CompositeOption(std::move(_opt_short), std::move(_opt_long), std::move(_description), _delimiter),
+          values()
+    {
+    }
+
+    /// @brief Constructs a copy of a `TupleOption` object under different names.
+    /// @param other The option to copy.
+    /// @param _opt_short The new short version of the option.
+    /// @param _opt_long The new long version of the option.
+    TupleOption(const TupleOption &other, std::string _opt_short, std::string _opt_long)
+        : CompositeOption(other, std::move(_opt_short), std::move(_opt_long)),
+          values(other.values)
+    {
+    }
+
+    /// @brief Virtual destructor.
+    virtual ~TupleOption() = default;
+
+    /// @details The last element takes the rest of the text, delimiters included.
+    virtual bool append(std::string_view text) override
+    {
+        tuple_t tuple;
+        if (!this->split(text, tuple)) {
+            return false;
+        }
+        values.push_back(std::move(tuple));
+        return true;
+    }
+
+    virtual bool accepts(std::string_view text) const override
+    {
+        tuple_t tuple;
+        return this->split(text, tuple);
+    }
+
+    virtual std::size_t count() const override
+    {
+        return values.size();
+    }
+
+    virtual std::string format_values() const override
+    {
+        std::string text;
+        for (const tuple_t &tuple : values) {
+            if (!text.empty()) {
+                text += ", ";
+            }
+            // Fold over the elements, prefixing all but the first with the delimiter.
+            std::size_t index = 0;
+            std::apply([&](const Ts &...elements) {
+                ((text += ((index++ > 0) ? std::string(1, delimiter) : std::string()) + format_value(elements)), ...);
+            }, tuple);
+        }
+        return text;
+    }
+
+    virtual Option *clone() const override
+    {
+        return new TupleOption(*this);
+    }
+
+    virtual Option *clone_as(std::string _opt_short, std::string _opt_long) const override
+    {
+        return new TupleOption(*this, std::move(_opt_short), std::move(_opt_long));
+    }
+
+    virtual void reset_value() override
+    {
+        values.clear();
+    }
+
+    virtual void get_memory_usage(MemoryUsage &usage) const override
+    {
+        usage.schema += sizeof(TupleOption);
+        this->get_text_memory_usage(usage);
+        usage.values += values.capacity() * sizeof(tuple_t);
+    }
+
+private:
+    /// @brief Splits a tuple at the delimiters and converts its elements.
+    /// @param text The text of the tuple, whose last element takes the rest of the text.
+    /// @param tuple The converted tuple.
+    /// @return False if the text does not hold a valid tuple.
+    bool split(std::string_view text, tuple_t &tuple) const
+    {
+        std::string_view fields[sizeof...(Ts)];
+        for (std::size_t i = 0; i + 1 < sizeof...(Ts); ++i) {
+            std::size_t position = text.find(delimiter);
+            if (position == std::string_view::npos) {
+                return false;
+            }
+            fields[i] = text.substr(0, position);
+            text      = text.substr(position + 1);
+        }
+        fields[sizeof...(Ts) - 1] = text;
+        return TupleOption::parse(fields, tuple, std::index_sequence_for<Ts...>());
+    }
+
+    /// @brief Converts the elements of a tuple.
+    template <std::size_t... I>
+    static bool parse(const std::string_view (&fields)[sizeof...(Ts)], tuple_t &tuple, std::index_sequence<I...>)
+    {
+        return (value_traits<Ts>::parse(fields[I], std::get<I>(tuple)) && ...);
+    }
+};
+
+/// @class LiveOption
+/// @brief A command-line option whose value can be changed while the program runs.
+/// @details The value is held by an atomic in the derived `LiveValueOption`,
+/// so that it can be set from a control thread while worker threads read it.
+class LiveOption : public Option {
+public:
+    /// @brief Whether the value was changed at runtime since it was last
+    /// assigned or reset, see `Parser::setLiveValue`.
+    std::atomic<bool> changed;
+
+    /// @brief Constructs a `LiveOption` object.
+    /// @param _opt_short The short version of the option (e.g., "-l").
+    /// @param _opt_long The long version of the option (e.g., "--log-level").
+    /// @param _description The description of the option.
+    LiveOption(std::string _opt_short, std::string _opt_long, std::string _description)
+        : Option(std::move(_opt_short), std::move(_opt_long), std::move(_description)),
+          changed(false)
+    {
+    }
+
+    /// @brief Constructs a copy of a `LiveOption` object under different names.
+    /// @param other The option to copy.
+    /// @param _opt_short The new short version of the option.
+    /// @param _opt_long The new long version of the option.
+    LiveOption(const LiveOption &other, std::string _opt_short, std::string _opt_long)
+        : Option(other, std::move(_opt_short), std::move(_opt_long)),
+          changed(other.changed.load(std::memory_order_relaxed))
+    {
+    }
+
+    /// @brief Virtual destructor.
+    virtual ~LiveOption() = default;
+
+    /// @brief Returns the name of the type of the value (e.g., "int" or "real").
+    virtual const char *type_name() const = 0;
+
+    /// @brief Tells whether a text is a valid value, without storing it.
+    virtual bool accepts(std::string_view text) const = 0;
+
+    /// @brief Converts a text and stores it as the new value.
+    /// @param text The text.
+    /// @return False if the text is not a valid value, in which case the value is unchanged.
+    virtual bool store(std::string_view text) = 0;
+
+    /// @brief Formats the current value.
+    virtual std::string load_text() const = 0;
+
+    /// @brief Formats the default value.
+    virtual std::string default_text() const = 0;
+
+    /// @brief Saves the current value, with no loss of precision.
+    /// @return The bytes of the value.
+    virtual std::string save() const = 0;
+
+    /// @brief Tells whether the current value is the saved one.
+    /// @param saved A value returned by `save`.
+    virtual bool holds(const std::string &saved) const = 0;
+
+    virtual bool takes_value() const override
+    {
+        return true;
+    }
+};
+
+/// @class LiveValueOption
+/// @brief A `LiveOption` holding a value of arithmetic type `T`.
+/// @tparam T The type of the value, which must be arithmetic.
+template <typename T>
+class LiveValueOption : public LiveOption {
+public:
+    static_assert(std::is_arithmetic<T>::value, "Live options must hold arithmetic values.");
+
+    /// @brief The current value, read and written with relaxed ordering.
+    std::atomic<T> value;
+    /// @brief The default value for this option.
+    const T default_value;
+
+    /// @brief Constructs a `LiveValueOption` object.
+    /// @param _opt_short The short version of the option (e.g., "-l").
+    /// @param _opt_long The long version of the option (e.g., "--log-level").
+    /// @param _description The description of the option.
+    /// @param _default_value The default value for the option.
+    LiveValueOption(std::string _opt_short, std::string _opt_long, std::string _description, T _default_value)
+        : LiveOption(std::move(_opt_short), std::move(_opt_long), std::move(_description)),
+          value(_default_value),
+          default_value(_default_value)
+    {
+    }
+
+    /// @brief Constructs a copy of a `LiveValueOption` object.
+    /// @param other The option to copy.
+    LiveValueOption(const LiveValueOption &other)
+        : LiveValueOption(other, other.opt_short, other.opt_long)
+    {
+    }
+
+    /// @brief Constructs a copy of a `LiveValueOption` object under different names.
+    /// @param other The option to copy.
+    /// @param _opt_short The new short version of the option.
+    /// @param _opt_long The new long version of the option.
+    LiveValueOption(const LiveValueOption &other, std::string _opt_short, std::string _opt_long)
+        : LiveOption(other, std::move(_opt_short), std::move(_opt_long)),
+          value(other.value.load(std::memory_order_relaxed)),
+          default_value(other.default_value)
+    {
+    }
+
+    /// @brief Virtual destructor.
+    virtual ~LiveValueOption() = default;
+
+    virtual const char *type_name() const override
+    {
+        if constexpr (std::is_same<T, bool>::value) {
+            return "bool";
+        } else if constexpr (std::is_floating_point<T>::value) {
+            return "real";
+        } else {
+            return std::is_signed<T>::value ? "int" : "uint";
+        }
+    }
+
+    virtual bool accepts(std::string_view text) const override
+    {
+        T converted{};
+        return value_traits<T>::parse(text, converted);
+    }
+
+    virtual bool store(std::string_view text) override
+    {
+        T converted{};
+        if (!value_traits<T>::parse(text, converted)) {
+            return false;
+        }
+        value.store(converted, std::memory_order_relaxed);
+        return true;
+    }
+
+    virtual std::string load_text() const override
+    {
+        return format_value(value.load(std::memory_order_relaxed));
+    }
+
+    virtual std::string default_text() const override
+    {
+        return format_value(default_value);
+    }
+
+    virtual std::string save() const override
+    {
+        T current = value.load(std::memory_order_relaxed);
+        return std::string(reinterpret_cast<const char *>(&current), sizeof(T));
+    }
+
+    virtual bool holds(const std::string &saved) const override
+    {
+        T previous{};
+        if (saved.size() != sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&previous, saved.data(), sizeof(T));
+        return previous == value.load(std::memory_order_relaxed);
+    }
+
+    virtual std::size_t get_value_length() const override
+    {
+        return format_value(default_value).size();
+    }
+
+    virtual Option *clone() const override
+    {
+        return new LiveValueOption(*this);
+    }
+
+    virtual Option *clone_as(std::string _opt_short, std::string _opt_long) const override
+    {
+        return new LiveValueOption(*this, std::move(_opt_short), std::move(_opt_long));
+    }
+
+    virtual void reset_value() override
+    {
+        value.store(default_value, std::memory_order_relaxed);
+        changed.store(false, std::memory_order_relaxed);
+    }
+
+    virtual void get_memory_usage(MemoryUsage &usage) const override
+    {
+        usage.schema += sizeof(LiveValueOption);
+        this->get_text_memory_usage(usage);
+    }
 };
 
 /// @class Separator
@@ -206,6 +1005,23 @@ public:
     {
         return 0;
     }
+
+    virtual Option *clone() const override
+    {
+        return new Separator(*this);
+    }
+
+    virtual Option *clone_as(std::string, std::string) const override
+    {
+        // Separators have no names.
+        return new Separator(*this);
+    }
+
+    virtual void get_memory_usage(MemoryUsage &usage) const override
+    {
+        usage.schema += sizeof(Separator);
+        this->get_text_memory_usage(usage);
+    }
 };
 
 } // namespace cmdlp::detail
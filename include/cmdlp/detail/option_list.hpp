@@ -4,10 +4,16 @@
 
 #pragma once
 
+#include "namespace_trie.hpp"
 #include "option.hpp"
 
+#include <algorithm>
+#include <array>
 #include <exception>
 #include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace cmdlp::detail
@@ -51,39 +57,47 @@ public:
     using iterator_t = std::vector<Option *>::iterator;
     /// @brief Alias for a const iterator over the option list.
     using const_iterator_t = std::vector<Option *>::const_iterator;
+    /// @brief Alias for the name-based index of the options, mapping names to slots.
+    using option_index_t = std::unordered_map<std::string, std::size_t>;
+    /// @brief The slot returned when an option cannot be found.
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+    /// @brief Alias for a column width of each help tier, indexed by tier.
+    using tier_widths_t = std::array<std::size_t, 3>;
 
     /// @brief Constructs an empty `OptionList`.
     OptionList()
         : options(),
-          longest_short_option(0),
-          longest_long_option(0),
-          longest_value(0)
+          index(),
+          namespaces(),
+          separators(),
+          longest_short_option(),
+          longest_long_option(),
+          longest_value()
     {
     }
 
     /// @brief Copy constructor.
     /// @param other The `OptionList` to copy.
-    /// @details Creates deep copies of the options in the list.
+    /// @details Creates deep copies of the options in the list, separators included.
     OptionList(const OptionList &other)
         : options(),
+          index(),
+          namespaces(),
+          separators(other.separators),
           longest_short_option(other.longest_short_option),
           longest_long_option(other.longest_long_option),
           longest_value(other.longest_value)
     {
-        const MultiOption *mopt;
-        const ToggleOption *topt;
-        const ValueOption *vopt;
+        options.reserve(other.options.size());
         for (const_iterator_t it = other.options.begin(); it != other.options.end(); ++it) {
-            if ((vopt = dynamic_cast<const ValueOption *>(*it))) {
-                options.emplace_back(new ValueOption(*vopt));
-            } else if ((topt = dynamic_cast<const ToggleOption *>(*it))) {
-                options.emplace_back(new ToggleOption(*topt));
-            } else if ((mopt = dynamic_cast<const MultiOption *>(*it))) {
-                options.emplace_back(new MultiOption(*mopt));
-            }
+            options.emplace_back((*it)->clone());
+            this->indexOption(options.size() - 1);
         }
     }
 
+    /// @brief Copy assignment is disabled, use the copy constructor instead.
+    OptionList &operator=(const OptionList &) = delete;
+
     /// @brief Destructor.
     /// @details Cleans up all dynamically allocated options.
     virtual ~OptionList()
@@ -98,14 +112,67 @@ public:
     /// @return A pointer to the `Option` if found, or `nullptr` otherwise.
     inline const Option *findOption(const std::string &option_string) const
     {
-        for (const_iterator_t it = options.begin(); it != options.end(); ++it) {
-            if (((*it)->opt_short == option_string) || ((*it)->opt_long == option_string)) {
-                return *it;
-            }
+        auto it = index.find(option_string);
+        if (it != index.end()) {
+            return options[it->second];
         }
         return nullptr;
     }
 
+    /// @brief Finds the slot of an option by its short or long name.
+    /// @param option_string The short or long name of the option.
+    /// @return The position of the option in the list, or `npos` if not found.
+    inline std::size_t findSlot(const std::string &option_string) const
+    {
+        auto it = index.find(option_string);
+        if (it != index.end()) {
+            return it->second;
+        }
+        return npos;
+    }
+
+    /// @brief Finds the options below a namespace.
+    /// @param prefix The namespace (e.g., "db.pool"), with or without leading dashes.
+    /// @return The slots of the options whose long name starts with the namespace, in slot order.
+    inline std::vector<std::size_t> findNamespace(const std::string &prefix) const
+    {
+        std::vector<std::size_t> slots;
+        namespaces.collect(prefix, slots);
+        std::sort(slots.begin(), slots.end());
+        return slots;
+    }
+
+    /// @brief Finds the section opened by the separator with the given description.
+    /// @param description The description of the separator.
+    /// @return The slot of the separator, or `npos` if not found.
+    /// @details Only the separators are visited, not the options.
+    inline std::size_t findSection(const std::string &description) const
+    {
+        for (std::size_t slot : separators) {
+            if (options[slot]->description == description) {
+                return slot;
+            }
+        }
+        return npos;
+    }
+
+    /// @brief Returns the end of the section opened by a separator.
+    /// @param slot The slot of the separator.
+    /// @return The slot of the next separator, or the size of the list.
+    inline std::size_t getSectionEnd(std::size_t slot) const
+    {
+        auto next = std::upper_bound(separators.begin(), separators.end(), slot);
+        return (next != separators.end()) ? *next : options.size();
+    }
+
+    /// @brief Returns the option stored in the given slot.
+    /// @param slot The position of the option in the list.
+    /// @return The option.
+    inline Option *getOptionAt(std::size_t slot) const
+    {
+        return options[slot];
+    }
+
     /// @brief Checks if an option exists by its name.
     /// @param option_string The short or long name of the option.
     /// @return True if the option exists, false otherwise.
@@ -117,60 +184,217 @@ public:
     /// @brief Retrieves the value of an option.
     /// @tparam T The expected type of the option value.
     /// @param option_string The short or long name of the option.
-    /// @return The value of the option, or the default value of `T` if not found.
+    /// @return The value of the option, or the default value of `T` if not found or empty.
+    /// @throws std::invalid_argument if the value cannot be converted to `T`.
     template <typename T>
     inline T getOption(const std::string &option_string) const
     {
-        const Option *option = this->findOption(option_string);
+        return OptionList::readOption<T>(this->findOption(option_string));
+    }
+
+    /// @brief Retrieves the value of an option.
+    /// @tparam T The expected type of the option value.
+    /// @param option The option, or `nullptr`.
+    /// @return The value of the option, or the default value of `T` if `option`
+    /// is `nullptr` or holds no value.
+    /// @throws std::invalid_argument if the value cannot be converted to `T`.
+    template <typename T>
+    static inline T readOption(const Option *option)
+    {
         if (option) {
+#ifdef CMDLP_ACCESS_STATS
+            option->stats->countRead();
+#endif
             const MultiOption *mopt;
             const ToggleOption *topt;
             const ValueOption *vopt;
-            std::stringstream ss;
+            const LiveOption *lopt;
+            std::string_view text;
+            std::string live_text;
             if ((vopt = dynamic_cast<const ValueOption *>(option))) {
-                ss << vopt->value;
+                text = vopt->value;
             } else if ((topt = dynamic_cast<const ToggleOption *>(option))) {
-                ss << topt->toggled;
+                text = topt->toggled ? "1" : "0";
             } else if ((mopt = dynamic_cast<const MultiOption *>(option))) {
-                ss << mopt->selected_value;
+                text = mopt->selected_value;
+            } else if ((lopt = dynamic_cast<const LiveOption *>(option))) {
+                live_text = lopt->load_text();
+                text      = live_text;
+            }
+            T data{};
+            if (!text.empty() && !value_traits<T>::parse(text, data)) {
+                throw std::invalid_argument("Value \"" + std::string(text) + "\" of option " + option->opt_long + " cannot be converted to the requested type");
             }
-            T data;
-            ss >> data;
             return data;
         }
-        return T(0);
+        return T{};
+    }
+
+    /// @brief Retrieves the value of an option without copying it.
+    /// @param option_string The short or long name of the option.
+    /// @return A view of the value, or an empty view if not found.
+    /// @throws std::invalid_argument if the option does not store its value as text.
+    /// @details The view points into the option, and remains valid until the
+    /// value changes, i.e., until the options are parsed or reset again.
+    inline std::string_view getOptionView(const std::string &option_string) const
+    {
+        return OptionList::readView(this->findOption(option_string));
+    }
+
+    /// @brief Retrieves the value of an option without copying it.
+    /// @param option The option, or `nullptr`.
+    /// @return A view of the value, or an empty view if `option` is `nullptr`.
+    /// @throws std::invalid_argument if the option does not store its value as text.
+    static inline std::string_view readView(const Option *option)
+    {
+        if (!option) {
+            return std::string_view();
+        }
+#ifdef CMDLP_ACCESS_STATS
+        option->stats->countRead();
+#endif
+        const MultiOption *mopt;
+        const ToggleOption *topt;
+        const ValueOption *vopt;
+        const ProfileOption *popt;
+        if ((vopt = dynamic_cast<const ValueOption *>(option))) {
+            return vopt->value;
+        } else if ((topt = dynamic_cast<const ToggleOption *>(option))) {
+            return topt->toggled ? "true" : "false";
+        } else if ((mopt = dynamic_cast<const MultiOption *>(option))) {
+            return mopt->selected_value;
+        } else if ((popt = dynamic_cast<const ProfileOption *>(option))) {
+            return popt->selected_profile;
+        } else if (!OptionList::hasTextValue(option)) {
+            throw std::invalid_argument("Option " + option->opt_long + " does not store its value as text, use getOption<std::string>");
+        }
+        return std::string_view();
+    }
+
+    /// @brief Tells whether the value of an option can be viewed with `readView`.
+    /// @param option The option.
+    /// @return False for composite and live options, which format their value on demand.
+    static inline bool hasTextValue(const Option *option)
+    {
+        return !dynamic_cast<const CompositeOption *>(option) && !dynamic_cast<const LiveOption *>(option);
+    }
+
+    /// @brief Retrieves the value of an option as a string.
+    /// @param option The option.
+    /// @return The value of the option, or an empty string if it holds no value.
+    static inline std::string getValue(const Option *option)
+    {
+        const MultiOption *mopt;
+        const ToggleOption *topt;
+        const ValueOption *vopt;
+        const ProfileOption *popt;
+        const CompositeOption *copt;
+        const LiveOption *lopt;
+        if ((vopt = dynamic_cast<const ValueOption *>(option))) {
+            return vopt->value;
+        } else if ((topt = dynamic_cast<const ToggleOption *>(option))) {
+            return topt->toggled ? "true" : "false";
+        } else if ((mopt = dynamic_cast<const MultiOption *>(option))) {
+            return mopt->selected_value;
+        } else if ((popt = dynamic_cast<const ProfileOption *>(option))) {
+            return popt->selected_profile;
+        } else if ((copt = dynamic_cast<const CompositeOption *>(option))) {
+            return copt->format_values();
+        } else if ((lopt = dynamic_cast<const LiveOption *>(option))) {
+            return lopt->load_text();
+        }
+        return "";
     }
 
     /// @brief Adds an option to the list.
     /// @param option The option to add.
     /// @throws OptionExistException if the option already exists.
+    /// @details The option is shown in the tier of its section, if less detailed.
     inline void addOption(Option *option)
     {
         // If the option is a separator, skip all checks.
         if (dynamic_cast<detail::Separator *>(option)) {
             options.push_back(option);
+            separators.push_back(options.size() - 1);
             return;
         }
 
         // Check if the option already exists in the list of options.
-        for (iterator_t it = options.begin(); it != options.end(); ++it) {
-            if ((*it)->opt_short == option->opt_short || (*it)->opt_long == option->opt_long) {
-                throw OptionExistException(option, *it);
+        for (const std::string *name : { &option->opt_short, &option->opt_long }) {
+            auto it = index.find(*name);
+            if (it != index.end()) {
+                throw OptionExistException(option, options[it->second]);
             }
         }
 
         // Add the option to the list of options.
+        this->inheritTier(option);
         options.push_back(option);
+        this->indexOption(options.size() - 1);
+        this->updateLongest(option);
+    }
 
-        // Update the length of the `longest` parameters.
-        if (option->opt_short.length() > longest_short_option) {
-            longest_short_option = option->opt_short.length();
-        }
-        if (option->opt_long.length() > longest_long_option) {
-            longest_long_option = option->opt_long.length();
+    /// @brief Adds copies of all the entries of a fragment, built separately, at the end of the list.
+    /// @param fragment The entries to copy, separators included.
+    /// @param prefix If not empty, the namespace the copies are placed in (e.g.,
+    /// "plugin" turns "--level" into "--plugin.level"); their short names are
+    /// dropped, as they would likely collide with the ones of other fragments.
+    /// @throws OptionExistException if a name is already in use, or two copies
+    /// get the same name (e.g., "-x" and "--x"), in which case nothing is added.
+    /// @throws std::invalid_argument if the fragment holds a profile option,
+    /// whose settings refer to the slots of the fragment.
+    inline void merge(const OptionList &fragment, const std::string &prefix = std::string())
+    {
+        std::vector<Option *> copies;
+        copies.reserve(fragment.size());
+        // The renamed copies, by name, which may collide with each other.
+        std::unordered_map<std::string, Option *> renamed;
+        try {
+            for (const_iterator_t it = fragment.begin(); it != fragment.end(); ++it) {
+                if (dynamic_cast<const ProfileOption *>(*it)) {
+                    throw std::invalid_argument("Cannot merge profile option: " + (*it)->opt_long);
+                }
+                if (prefix.empty() || dynamic_cast<const Separator *>(*it)) {
+                    copies.push_back((*it)->clone());
+                    continue;
+                }
+                const std::string &name = (*it)->opt_long.empty() ? (*it)->opt_short : (*it)->opt_long;
+                copies.push_back((*it)->clone_as("", "--" + prefix + "." + name.substr(std::min(name.find_first_not_of('-'), name.size()))));
+                // Check the new name against the index, and against the other copies.
+                auto existing = index.find(copies.back()->opt_long);
+                if (existing != index.end()) {
+                    throw OptionExistException(copies.back(), options[existing->second]);
+                }
+                auto inserted = renamed.emplace(copies.back()->opt_long, copies.back());
+                if (!inserted.second) {
+                    throw OptionExistException(copies.back(), inserted.first->second);
+                }
+            }
+            // Without a prefix, both names are checked.
+            for (std::size_t i = 0; prefix.empty() && (i < copies.size()); ++i) {
+                for (const std::string *name : { &copies[i]->opt_short, &copies[i]->opt_long }) {
+                    auto existing = name->empty() ? index.end() : index.find(*name);
+                    if (existing != index.end()) {
+                        throw OptionExistException(copies[i], options[existing->second]);
+                    }
+                }
+            }
+        } catch (...) {
+            for (Option *copy : copies) {
+                delete copy;
+            }
+            throw;
         }
-        if (option->get_value_length() > longest_value) {
-            longest_value = option->get_value_length();
+        options.reserve(options.size() + copies.size());
+        for (Option *copy : copies) {
+            options.push_back(copy);
+            if (dynamic_cast<Separator *>(copy)) {
+                separators.push_back(options.size() - 1);
+            } else {
+                this->inheritTier(copy);
+                this->indexOption(options.size() - 1);
+                this->updateLongest(copy);
+            }
         }
     }
 
@@ -186,71 +410,155 @@ public:
         return options.end();
     }
 
+    /// @brief Adds the memory used by the options and their index to the given report.
+    /// @param usage The report to update.
+    inline void getMemoryUsage(MemoryUsage &usage) const
+    {
+        usage.schema += sizeof(OptionList) + options.capacity() * sizeof(Option *);
+        for (const_iterator_t it = options.begin(); it != options.end(); ++it) {
+            (*it)->get_memory_usage(usage);
+        }
+        usage.indices += heap_size(index);
+        namespaces.getMemoryUsage(usage);
+        usage.indices += separators.capacity() * sizeof(std::size_t);
+    }
+
+    /// @brief Returns the number of entries, separators included.
+    inline std::size_t size() const
+    {
+        return options.size();
+    }
+
     /// @brief Retrieves the length of the longest short option name.
     /// @tparam T The type to return (default is `std::size_t`).
+    /// @param tier Only considers the options shown in this tier (default is all of them).
     /// @return The length of the longest short option name.
     template <typename T = std::size_t>
-    inline T getLongestShortOption() const
+    inline T getLongestShortOption(HelpTier tier = HelpTier::hidden) const
     {
-        return static_cast<T>(longest_short_option);
+        return static_cast<T>(longest_short_option[static_cast<std::size_t>(tier)]);
     }
 
     /// @brief Retrieves the length of the longest long option name.
     /// @tparam T The type to return (default is `std::size_t`).
+    /// @param tier Only considers the options shown in this tier (default is all of them).
     /// @return The length of the longest long option name.
     template <typename T = std::size_t>
-    inline T getLongestLongOption() const
+    inline T getLongestLongOption(HelpTier tier = HelpTier::hidden) const
     {
-        return static_cast<T>(longest_long_option);
+        return static_cast<T>(longest_long_option[static_cast<std::size_t>(tier)]);
     }
 
     /// @brief Retrieves the length of the longest value.
     /// @tparam T The type to return (default is `std::size_t`).
+    /// @param tier Only considers the options shown in this tier (default is all of them).
     /// @return The length of the longest value.
     template <typename T = std::size_t>
-    inline T getLongestValue() const
+    inline T getLongestValue(HelpTier tier = HelpTier::hidden) const
     {
-        return static_cast<T>(longest_value);
+        return static_cast<T>(longest_value[static_cast<std::size_t>(tier)]);
     }
 
     /// @brief Updates the length of the longest value.
     /// @param length The new length to consider.
-    inline void updateLongestValue(std::size_t length)
+    /// @param tier The tier of the option holding the value.
+    /// @details Only affects the layout of the help, so it is allowed on a
+    /// const list, whose values may be computed lazily.
+    inline void updateLongestValue(std::size_t length, HelpTier tier) const
     {
-        if (length > longest_value) {
-            longest_value = length;
+        for (std::size_t t = static_cast<std::size_t>(tier); t < longest_value.size(); ++t) {
+            longest_value[t] = std::max(longest_value[t], length);
+        }
+    }
+
+    /// @brief Moves a range of entries to another tier of the help.
+    /// @param first The slot of the first option or separator.
+    /// @param last The slot following the last one.
+    /// @param tier The new tier.
+    /// @details The column widths of all tiers are computed again, which
+    /// requires visiting all the options.
+    inline void setTier(std::size_t first, std::size_t last, HelpTier tier)
+    {
+        for (std::size_t slot = first; slot < last; ++slot) {
+            options[slot]->tier = tier;
+        }
+        longest_short_option.fill(0);
+        longest_long_option.fill(0);
+        longest_value.fill(0);
+        for (const_iterator_t it = options.begin(); it != options.end(); ++it) {
+            if (!dynamic_cast<const Separator *>(*it)) {
+                this->updateLongest(*it);
+            }
         }
     }
 
 private:
+    /// @brief Moves an option being added to the tier of its section, the one
+    /// opened by the last separator, if that tier is more detailed.
+    /// @param option The option.
+    inline void inheritTier(Option *option) const
+    {
+        if (!separators.empty()) {
+            option->tier = std::max(option->tier, options[separators.back()]->tier);
+        }
+    }
+
+    /// @brief Updates the length of the `longest` parameters with the ones of an option.
+    /// @param option The option.
+    /// @details The widths of the tiers showing the option are updated.
+    inline void updateLongest(const Option *option)
+    {
+        for (std::size_t t = static_cast<std::size_t>(option->tier); t < longest_value.size(); ++t) {
+            longest_short_option[t] = std::max(longest_short_option[t], option->opt_short.length());
+            longest_long_option[t]  = std::max(longest_long_option[t], option->opt_long.length());
+            longest_value[t]        = std::max(longest_value[t], option->get_value_length());
+        }
+    }
+
+    /// @brief Adds the names of the option in the given slot to the index.
+    /// @param slot The position of the option to index.
+    /// @details Empty names are not indexed, so options without a short or long
+    /// version never conflict with each other.
+    inline void indexOption(std::size_t slot)
+    {
+        if (!options[slot]->opt_short.empty()) {
+            index.emplace(options[slot]->opt_short, slot);
+        }
+        if (!options[slot]->opt_long.empty()) {
+            index.emplace(options[slot]->opt_long, slot);
+        }
+        if (NamespaceTrie::isDotted(options[slot]->opt_long)) {
+            namespaces.insert(options[slot]->opt_long, slot);
+        }
+    }
+
     /// @brief The list of options.
     option_list_t options;
-    /// @brief The length of the longest short option name.
-    std::size_t longest_short_option;
-    /// @brief The length of the longest long option name.
-    std::size_t longest_long_option;
-    /// @brief The length of the longest value.
-    std::size_t longest_value;
+    /// @brief Maps both the short and the long names to their option.
+    option_index_t index;
+    /// @brief Indexes the dotted long names by segment.
+    NamespaceTrie namespaces;
+    /// @brief The slots of the separators, in increasing order.
+    std::vector<std::size_t> separators;
+    /// @brief The length of the longest short option name, for each tier.
+    tier_widths_t longest_short_option;
+    /// @brief The length of the longest long option name, for each tier.
+    tier_widths_t longest_long_option;
+    /// @brief The length of the longest value, for each tier.
+    mutable tier_widths_t longest_value;
 };
 
-/// @brief Specialization of `getOption` for `std::string`.
-/// @param option_string The short or long name of the option.
-/// @return The value of the option as a string, or an empty string if not found.
+/// @brief Specialization of `readOption` for `std::string`.
+/// @param option The option, or `nullptr`.
+/// @return The value of the option as a string, or an empty string if `option` is `nullptr`.
 template <>
-std::string OptionList::getOption(const std::string &option_string) const
+inline std::string OptionList::readOption(const Option *option)
 {
-    const Option *option = this->findOption(option_string);
     if (option) {
-        const MultiOption *mopt;
-        const ToggleOption *topt;
-        const ValueOption *vopt;
-        if ((vopt = dynamic_cast<const ValueOption *>(option))) {
-            return vopt->value;
-        } else if ((topt = dynamic_cast<const ToggleOption *>(option))) {
-            return topt->toggled ? "true" : "false";
-        } else if ((mopt = dynamic_cast<const MultiOption *>(option))) {
-            return mopt->selected_value;
-        }
+#ifdef CMDLP_ACCESS_STATS
+        option->stats->countRead();
+#endif
+        return OptionList::getValue(option);
     }
     return "";
 }
@@ -0,0 +1,264 @@
+/// @file parse_event.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the events produced while walking the command-line arguments.
+
+#pragma once
+
+#include "option_list.hpp"
+#include "tokenizer.hpp"
+
+#include <cctype>
+#include <istream>
+#include <string_view>
+
+namespace cmdlp::detail
+{
+
+/// @struct ParseEvent
+/// @brief Describes a registered option, or a positional argument, found on the command line.
+/// @details When walking a `Tokenizer`, the views point into its storage and
+/// remain valid as long as its arguments are not replaced.
+struct ParseEvent {
+    /// @brief The slot of the option in the `OptionList`, `OptionList::npos` for positional arguments.
+    std::size_t slot;
+    /// @brief The option, `nullptr` for positional arguments.
+    const Option *option;
+    /// @brief The token as written on the command line (e.g., "-o" or "--option").
+    std::string_view name;
+    /// @brief The value following the option, or the positional argument itself.
+    std::string_view value;
+    /// @brief Whether a value was found, always false for toggles.
+    bool has_value;
+    /// @brief The position of the token, the program name excluded.
+    std::size_t token_index;
+
+    /// @brief Tells whether the event describes a positional argument.
+    inline bool isPositional() const
+    {
+        return option == nullptr;
+    }
+};
+
+/// @class TokenizerSource
+/// @brief Provides the tokens of a `Tokenizer` to a `BasicEventCursor`.
+class TokenizerSource {
+public:
+    /// @brief Starts from the first token.
+    /// @param _tokenizer The arguments.
+    explicit TokenizerSource(const Tokenizer &_tokenizer)
+        : tokenizer(_tokenizer),
+          position(0)
+    {
+    }
+
+    /// @brief Returns the next token without consuming it.
+    /// @return The token, or `nullptr` when there are no more tokens.
+    inline const std::string *peek()
+    {
+        return (position < tokenizer.size()) ? &tokenizer.getToken(position) : nullptr;
+    }
+
+    /// @brief Consumes the next token.
+    inline void pop()
+    {
+        ++position;
+    }
+
+    /// @brief Returns the position of the next token.
+    inline std::size_t getPosition() const
+    {
+        return position;
+    }
+
+private:
+    /// @brief The arguments.
+    const Tokenizer &tokenizer;
+    /// @brief The position of the next token.
+    std::size_t position;
+};
+
+/// @class StreamSource
+/// @brief Reads tokens lazily from a stream, and provides them to a `BasicEventCursor`.
+/// @details Tokens are separated by whitespace. Single and double quotes group
+/// whitespace into a token, and a backslash escapes the next character outside
+/// single quotes, as in response files. Only the last two tokens are kept in
+/// memory, so the footprint does not depend on the length of the stream.
+class StreamSource {
+public:
+    /// @brief Starts reading from the current position of the stream.
+    /// @param _input The stream.
+    explicit StreamSource(std::istream &_input)
+        : input(_input),
+          buffers(),
+          position(0),
+          loaded(false)
+    {
+    }
+
+    /// @brief Returns the next token without consuming it, reading it if needed.
+    /// @return The token, or `nullptr` when the stream is over.
+    inline const std::string *peek()
+    {
+        std::string &buffer = buffers[position % 2];
+        if (!loaded) {
+            if (!StreamSource::readToken(input, buffer)) {
+                return nullptr;
+            }
+            loaded = true;
+        }
+        return &buffer;
+    }
+
+    /// @brief Consumes the next token.
+    /// @details The consumed token stays valid until the following one is consumed.
+    inline void pop()
+    {
+        ++position;
+        loaded = false;
+    }
+
+    /// @brief Returns the position of the next token.
+    inline std::size_t getPosition() const
+    {
+        return position;
+    }
+
+    /// @brief Returns the bytes reserved for the tokens kept in memory.
+    inline std::size_t getBufferSize() const
+    {
+        return buffers[0].capacity() + buffers[1].capacity();
+    }
+
+    /// @brief Reads a single token from a stream.
+    /// @param in The stream.
+    /// @param token The token to fill, its storage is reused.
+    /// @return False if the stream ended before a token was found.
+    static bool readToken(std::istream &in, std::string &token)
+    {
+        token.clear();
+        std::istream::int_type c;
+        // Skip the leading whitespace.
+        while (((c = in.get()) != std::istream::traits_type::eof()) && std::isspace(c)) {}
+        if (c == std::istream::traits_type::eof()) {
+            return false;
+        }
+        char quote = 0;
+        for (; c != std::istream::traits_type::eof(); c = in.get()) {
+            if (quote) {
+                if (c == quote) {
+                    quote = 0;
+                    continue;
+                }
+            } else if (std::isspace(c)) {
+                break;
+            } else if ((c == '"') || (c == '\'')) {
+                quote = static_cast<char>(c);
+                continue;
+            }
+            if ((c == '\\') && (quote != '\'')) {
+                c = in.get();
+                if (c == std::istream::traits_type::eof()) {
+                    break;
+                }
+            }
+            token.push_back(static_cast<char>(c));
+        }
+        return true;
+    }
+
+private:
+    /// @brief The stream.
+    std::istream &input;
+    /// @brief The storage of the last two tokens.
+    std::string buffers[2];
+    /// @brief The position of the next token.
+    std::size_t position;
+    /// @brief Whether the next token has already been read.
+    bool loaded;
+};
+
+/// @class BasicEventCursor
+/// @brief Walks the arguments once, producing an event for each registered option and positional argument.
+/// @tparam Source Provides the tokens, either `TokenizerSource` or `StreamSource`.
+/// @details Events are pulled one at a time with `next`, tokens are only read
+/// when needed. Options holding a value consume the following token, unless it
+/// is itself an option. Unknown options are skipped. Walking the arguments of
+/// a `Tokenizer` performs no allocation; when reading from a stream, the views
+/// held by an event are valid until the following call to `next`.
+template <typename Source>
+class BasicEventCursor {
+public:
+    /// @brief Starts walking the arguments.
+    /// @tparam Input The input of the source, a `Tokenizer` or a `std::istream`.
+    /// @param input The arguments.
+    /// @param _options The registered options.
+    template <typename Input>
+    BasicEventCursor(Input &input, const OptionList &_options)
+        : source(input),
+          options(_options)
+    {
+    }
+
+    /// @brief Produces the next event.
+    /// @param event The event to fill.
+    /// @return False when all the arguments have been walked.
+    bool next(ParseEvent &event)
+    {
+        const std::string *token;
+        while ((token = source.peek())) {
+            event.slot        = options.findSlot(*token);
+            event.token_index = source.getPosition();
+            source.pop();
+            if (event.slot != OptionList::npos) {
+                event.option    = options.getOptionAt(event.slot);
+                event.name      = *token;
+                event.value     = std::string_view();
+                event.has_value = false;
+                if (event.option->takes_value() && (token = source.peek()) && !Tokenizer::isOption(*token)) {
+                    event.value     = *token;
+                    event.has_value = true;
+                    source.pop();
+                }
+                return true;
+            }
+            if (!Tokenizer::isOption(*token)) {
+                event.option    = nullptr;
+                event.name      = std::string_view();
+                event.value     = *token;
+                event.has_value = true;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Returns the bytes reserved for the tokens kept in memory, when reading from a stream.
+    /// @return The size, which depends on the longest token read, not on the number of tokens.
+    inline std::size_t getBufferSize() const
+    {
+        return source.getBufferSize();
+    }
+
+private:
+    /// @brief Provides the tokens.
+    Source source;
+    /// @brief The registered options.
+    const OptionList &options;
+};
+
+/// @brief Walks the arguments stored in a `Tokenizer`.
+using EventCursor = BasicEventCursor<TokenizerSource>;
+/// @brief Walks the arguments read lazily from a stream.
+using StreamEventCursor = BasicEventCursor<StreamSource>;
+
+} // namespace cmdlp::detail
+
+namespace cmdlp
+{
+
+/// @brief An option, or a positional argument, found on the command line (see `Parser::parseEvents`).
+using ParseEvent = detail::ParseEvent;
+/// @brief Produces the events of the arguments read lazily from a stream (see `Parser::streamEvents`).
+using EventCursor = detail::StreamEventCursor;
+
+} // namespace cmdlp
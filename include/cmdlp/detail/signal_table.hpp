@@ -0,0 +1,256 @@
+/// @file signal_table.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the double-buffered table of option values readable from signal handlers.
+
+#pragma once
+
+#include "memory_usage.hpp"
+#include "option_list.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace cmdlp
+{
+
+/// @struct SignalSafeHandle
+/// @brief Identifies an option made readable from signal handlers, see `Parser::addSignalSafe`.
+struct SignalSafeHandle {
+    /// @brief The position of the option in the table.
+    std::size_t index;
+};
+
+} // namespace cmdlp
+
+namespace cmdlp::detail
+{
+
+/// @class SignalTable
+/// @brief Holds a copy of the values of selected options, converted in advance.
+/// @details Values are published into one of two buffers while the other one
+/// is being read, then the buffers are swapped with an atomic store. Readers
+/// only perform atomic operations and copies: they never allocate, lock or
+/// throw, and are thus async-signal-safe. A reader announces itself on the
+/// buffer it reads, so that the publisher waits for it before reusing the
+/// buffer; a signal handler interrupting the publisher always reads the
+/// other buffer, so the publisher never waits for it.
+class SignalTable {
+public:
+    static_assert(std::atomic<unsigned>::is_always_lock_free, "Signal-safe readers need lock-free atomics.");
+
+    /// @brief Constructs an empty table.
+    SignalTable()
+        : slots(),
+          buffers(),
+          active(0)
+    {
+    }
+
+    /// @brief Copies the options and their last published values.
+    /// @param other The table to copy, which must not be published concurrently.
+    SignalTable(const SignalTable &other)
+        : slots(other.slots),
+          buffers(),
+          active(0)
+    {
+        const Buffer &buffer = other.buffers[other.active.load(std::memory_order_acquire)];
+        buffers[0].entries   = buffer.entries;
+        buffers[0].text      = buffer.text;
+    }
+
+    SignalTable &operator=(const SignalTable &) = delete;
+
+    /// @brief Tells whether no option is in the table.
+    inline bool empty() const
+    {
+        return slots.empty();
+    }
+
+    /// @brief Returns the slots of the options in the table.
+    inline const std::vector<std::size_t> &getSlots() const
+    {
+        return slots;
+    }
+
+    /// @brief Tells whether an option is in the table.
+    /// @param slot The slot of the option.
+    inline bool contains(std::size_t slot) const
+    {
+        return std::find(slots.begin(), slots.end(), slot) != slots.end();
+    }
+
+    /// @brief Adds an option to the table, once.
+    /// @param slot The slot of the option.
+    /// @return The position of the option in the table.
+    std::size_t add(std::size_t slot)
+    {
+        for (std::size_t index = 0; index < slots.size(); ++index) {
+            if (slots[index] == slot) {
+                return index;
+            }
+        }
+        slots.push_back(slot);
+        return slots.size() - 1;
+    }
+
+    /// @brief Converts the current values of the options and makes them visible to readers.
+    /// @param options The options.
+    /// @details Must not be called from a signal handler, nor concurrently with itself.
+    void publish(const OptionList &options)
+    {
+        unsigned target = 1U - active.load(std::memory_order_relaxed);
+        Buffer &buffer  = buffers[target];
+        // Wait for the readers still holding the values published two times ago.
+        while (buffer.readers.load(std::memory_order_seq_cst) != 0) {
+        }
+        buffer.entries.resize(slots.size());
+        buffer.text.clear();
+        for (std::size_t index = 0; index < slots.size(); ++index) {
+            const std::string value = OptionList::getValue(options.getOptionAt(slots[index]));
+            Entry &entry            = buffer.entries[index];
+            entry.offset            = buffer.text.size();
+            entry.length            = value.size();
+            entry.toggled           = (value == "true") || (value == "1");
+            entry.has_integer       = value_traits<long long>::parse(value, entry.integer);
+            entry.has_real          = value_traits<double>::parse(value, entry.real);
+            buffer.text.insert(buffer.text.end(), value.begin(), value.end());
+            buffer.text.push_back('\0');
+        }
+        active.store(target, std::memory_order_seq_cst);
+    }
+
+    /// @brief Copies the text of a value, as `snprintf` does.
+    /// @param index The position of the option.
+    /// @param out The buffer, always null-terminated when `size` is not zero.
+    /// @param size The size of the buffer.
+    /// @return The length of the value, or 0 if it was not published.
+    std::size_t readText(std::size_t index, char *out, std::size_t size) const noexcept
+    {
+        std::size_t length = 0;
+        if (size > 0) {
+            out[0] = '\0';
+        }
+        this->read(index, [&](const Buffer &buffer, const Entry &entry) {
+            length            = entry.length;
+            std::size_t count = (length < size) ? length : ((size > 0) ? (size - 1) : 0);
+            std::memcpy(out, buffer.text.data() + entry.offset, count);
+            if (size > 0) {
+                out[count] = '\0';
+            }
+            return true;
+        });
+        return length;
+    }
+
+    /// @brief Reads a value as an integer.
+    /// @param index The position of the option.
+    /// @param value Set to the value, if it is an integer.
+    /// @return False if the value was not published or is not an integer.
+    bool readInteger(std::size_t index, long long &value) const noexcept
+    {
+        return this->read(index, [&](const Buffer &, const Entry &entry) {
+            value = entry.integer;
+            return entry.has_integer;
+        });
+    }
+
+    /// @brief Reads a value as a floating-point number.
+    /// @param index The position of the option.
+    /// @param value Set to the value, if it is a number.
+    /// @return False if the value was not published or is not a number.
+    bool readReal(std::size_t index, double &value) const noexcept
+    {
+        return this->read(index, [&](const Buffer &, const Entry &entry) {
+            value = entry.real;
+            return entry.has_real;
+        });
+    }
+
+    /// @brief Reads a value as a toggle, "true" and "1" being set.
+    /// @param index The position of the option.
+    /// @param value Set to the state of the toggle.
+    /// @return False if the value was not published.
+    bool readToggle(std::size_t index, bool &value) const noexcept
+    {
+        return this->read(index, [&](const Buffer &, const Entry &entry) {
+            value = entry.toggled;
+            return true;
+        });
+    }
+
+    /// @brief Adds the memory used by the table to the given report.
+    /// @param usage The report to update.
+    void getMemoryUsage(MemoryUsage &usage) const
+    {
+        usage.indices += slots.capacity() * sizeof(std::size_t);
+        for (const Buffer &buffer : buffers) {
+            usage.values += buffer.entries.capacity() * sizeof(Entry) + buffer.text.capacity();
+        }
+    }
+
+private:
+    /// @brief A value, with its conversions.
+    struct Entry {
+        /// @brief The position of the text in the buffer.
+        std::size_t offset = 0;
+        /// @brief The length of the text.
+        std::size_t length = 0;
+        /// @brief The value as an integer, if `has_integer`.
+        long long integer = 0;
+        /// @brief The value as a floating-point number, if `has_real`.
+        double real = 0;
+        /// @brief The value as a toggle.
+        bool toggled = false;
+        /// @brief Whether the value is an integer.
+        bool has_integer = false;
+        /// @brief Whether the value is a floating-point number.
+        bool has_real = false;
+    };
+
+    /// @brief A published copy of the values.
+    struct Buffer {
+        /// @brief The values, one per option.
+        std::vector<Entry> entries;
+        /// @brief The text of the values, each null-terminated.
+        std::vector<char> text;
+        /// @brief The number of readers currently using the buffer.
+        mutable std::atomic<unsigned> readers{ 0 };
+    };
+
+    /// @brief Calls a function on the published value of an option, keeping its buffer alive.
+    /// @tparam Function A callable accepting a buffer and an entry, returning a `bool`.
+    /// @param index The position of the option.
+    /// @param function The function, which must be async-signal-safe.
+    /// @return False if the value was not published, the result of the function otherwise.
+    template <typename Function>
+    bool read(std::size_t index, Function function) const noexcept
+    {
+        const Buffer *buffer;
+        // Retry if the buffers were swapped before this reader was announced.
+        for (;;) {
+            unsigned current = active.load(std::memory_order_seq_cst);
+            buffer           = &buffers[current];
+            buffer->readers.fetch_add(1, std::memory_order_seq_cst);
+            if (active.load(std::memory_order_seq_cst) == current) {
+                break;
+            }
+            buffer->readers.fetch_sub(1, std::memory_order_seq_cst);
+        }
+        bool result = (index < buffer->entries.size()) && function(*buffer, buffer->entries[index]);
+        buffer->readers.fetch_sub(1, std::memory_order_seq_cst);
+        return result;
+    }
+
+    /// @brief The slots of the options in the table.
+    std::vector<std::size_t> slots;
+    /// @brief The two buffers, one published and one being written.
+    std::array<Buffer, 2> buffers;
+    /// @brief The position of the published buffer.
+    std::atomic<unsigned> active;
+};
+
+} // namespace cmdlp::detail
@@ -0,0 +1,255 @@
+/// @file socket.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Helpers for exchanging messages over local Unix sockets.
+
+#pragma once
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace cmdlp::detail
+{
+
+/// @brief Builds the address of a Unix socket.
+/// @param path The filesystem path of the socket.
+/// @return The address.
+/// @throws std::invalid_argument if the path does not fit in the address.
+inline sockaddr_un make_socket_address(const std::string &path)
+{
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || (path.size() >= sizeof(address.sun_path))) {
+        throw std::invalid_argument("Invalid socket path: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+/// @brief Builds an exception describing the last system error.
+/// @param what The operation that failed.
+/// @return The exception.
+inline std::runtime_error system_error(const std::string &what)
+{
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+/// @brief Removes a stale socket before binding a new one at the same path.
+/// @param path The filesystem path of the socket.
+/// @throws std::runtime_error if something other than a socket exists at the path.
+inline void remove_stale_socket(const std::string &path)
+{
+    struct stat info;
+    if (::lstat(path.c_str(), &info) < 0) {
+        return;
+    }
+    if (!S_ISSOCK(info.st_mode)) {
+        throw std::runtime_error("Refusing to replace " + path + ": it is not a socket");
+    }
+    ::unlink(path.c_str());
+}
+
+/// @brief Retrieves the user owning the process at the other end of a Unix socket.
+/// @param fd The connected socket.
+/// @param uid Set to the effective user ID of the peer.
+/// @return True on success, false otherwise.
+inline bool peer_uid(int fd, uid_t &uid)
+{
+#if defined(__APPLE__)
+    gid_t gid;
+    return ::getpeereid(fd, &uid, &gid) == 0;
+#else
+    ucred credentials;
+    socklen_t length = sizeof(credentials);
+    if (::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) < 0) {
+        return false;
+    }
+    uid = credentials.uid;
+    return true;
+#endif
+}
+
+/// @brief Makes the reads from a socket fail after a period of inactivity.
+/// @param fd The socket.
+/// @param timeout The longest wait for incoming data, zero to wait forever.
+/// @return True on success, false otherwise.
+inline bool set_receive_timeout(int fd, std::chrono::milliseconds timeout)
+{
+    timeval tv;
+    tv.tv_sec  = static_cast<time_t>(timeout.count() / 1000);
+    tv.tv_usec = static_cast<suseconds_t>((timeout.count() % 1000) * 1000);
+    return ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) == 0;
+}
+
+/// @brief Writes the whole buffer, retrying on partial writes.
+/// @param fd The file descriptor, a socket where `MSG_NOSIGNAL` is available.
+/// @param data The data to write.
+/// @param size The number of bytes to write.
+/// @return True on success, false if the descriptor was closed or failed.
+/// @details Where supported, a peer that went away makes the write fail
+/// instead of raising `SIGPIPE` in the writer.
+inline bool write_all(int fd, const void *data, std::size_t size)
+{
+    const char *ptr = static_cast<const char *>(data);
+    while (size > 0) {
+#ifdef MSG_NOSIGNAL
+        ssize_t written = ::send(fd, ptr, size, MSG_NOSIGNAL);
+#else
+        ssize_t written = ::write(fd, ptr, size);
+#endif
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        ptr += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+/// @brief Reads exactly the given number of bytes, retrying on partial reads.
+/// @param fd The file descriptor.
+/// @param data The buffer to fill.
+/// @param size The number of bytes to read.
+/// @return True on success, false if the descriptor was closed or failed.
+inline bool read_all(int fd, void *data, std::size_t size)
+{
+    char *ptr = static_cast<char *>(data);
+    while (size > 0) {
+        ssize_t count = ::read(fd, ptr, size);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        ptr += count;
+        size -= static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+/// @brief Writes a list of strings, each one prefixed by its length.
+/// @param fd The file descriptor.
+/// @param strings The strings to write.
+/// @return True on success, false otherwise.
+inline bool write_strings(int fd, const std::vector<std::string> &strings)
+{
+    auto count = static_cast<uint32_t>(strings.size());
+    if (!write_all(fd, &count, sizeof(count))) {
+        return false;
+    }
+    for (const std::string &str : strings) {
+        auto length = static_cast<uint32_t>(str.size());
+        if (!write_all(fd, &length, sizeof(length)) || !write_all(fd, str.data(), str.size())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief Reads a list of strings written by `write_strings`.
+/// @param fd The file descriptor.
+/// @param strings The list to fill.
+/// @param max_count The largest number of strings accepted.
+/// @param max_length The longest string accepted.
+/// @return True on success, false otherwise, including when a limit is exceeded.
+/// @details The limits are checked before allocating, so that a peer cannot
+/// make the reader allocate more than it actually sends.
+inline bool read_strings(int fd, std::vector<std::string> &strings, uint32_t max_count = 65536, uint32_t max_length = 1U << 20)
+{
+    uint32_t count;
+    if (!read_all(fd, &count, sizeof(count)) || (count > max_count)) {
+        return false;
+    }
+    strings.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t length;
+        if (!read_all(fd, &length, sizeof(length)) || (length > max_length)) {
+            return false;
+        }
+        strings.emplace_back(length, '\0');
+        if ((length > 0) && !read_all(fd, &strings.back()[0], length)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief Sends file descriptors over a Unix socket, along with a single byte.
+/// @param fd The socket.
+/// @param fds The descriptors to send.
+/// @return True on success, false otherwise.
+inline bool send_fds(int fd, const std::vector<int> &fds)
+{
+    char byte = 0;
+    iovec iov;
+    iov.iov_base = &byte;
+    iov.iov_len  = 1;
+    std::vector<char> control(CMSG_SPACE(sizeof(int) * fds.size()), 0);
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control.data();
+    msg.msg_controllen = static_cast<socklen_t>(control.size());
+    cmsghdr *cmsg      = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level   = SOL_SOCKET;
+    cmsg->cmsg_type    = SCM_RIGHTS;
+    cmsg->cmsg_len     = static_cast<socklen_t>(CMSG_LEN(sizeof(int) * fds.size()));
+    std::memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+    return ::sendmsg(fd, &msg, 0) == 1;
+}
+
+/// @brief Receives the file descriptors sent by `send_fds`.
+/// @param fd The socket.
+/// @param fds The list to fill, resized to the number of expected descriptors.
+/// @return True if all the expected descriptors were received, false otherwise.
+inline bool recv_fds(int fd, std::vector<int> &fds)
+{
+    char byte;
+    iovec iov;
+    iov.iov_base = &byte;
+    iov.iov_len  = 1;
+    std::vector<char> control(CMSG_SPACE(sizeof(int) * fds.size()), 0);
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control.data();
+    msg.msg_controllen = static_cast<socklen_t>(control.size());
+    if (::recvmsg(fd, &msg, 0) != 1) {
+        return false;
+    }
+    cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    if (!cmsg || (cmsg->cmsg_level != SOL_SOCKET) || (cmsg->cmsg_type != SCM_RIGHTS)) {
+        return false;
+    }
+    if (cmsg->cmsg_len != CMSG_LEN(sizeof(int) * fds.size())) {
+        // Close whatever was received, instead of leaking it.
+        std::size_t received = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (std::size_t i = 0; i < received; ++i) {
+            int received_fd;
+            std::memcpy(&received_fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+            ::close(received_fd);
+        }
+        return false;
+    }
+    std::memcpy(fds.data(), CMSG_DATA(cmsg), sizeof(int) * fds.size());
+    return true;
+}
+
+} // namespace cmdlp::detail
@@ -4,10 +4,13 @@
 
 #pragma once
 
+#include "memory_usage.hpp"
+
 #include <vector>
 #include <string>
 #include <algorithm>
 #include <cctype>
+#include <unordered_map>
 
 namespace cmdlp::detail
 {
@@ -20,6 +23,11 @@ class Tokenizer {
 private:
     /// @brief Stores the arguments as a list of strings.
     std::vector<std::string> tokens;
+    /// @brief Maps each distinct token to the position of its first occurrence.
+    /// @details Keeps lookups constant-time, so that parsing stays linear in the
+    /// number of arguments and registered options. It is built on first lookup,
+    /// since walking the arguments in order does not need it.
+    mutable std::unordered_map<std::string, std::size_t> index;
 
 public:
     /// @brief Initializes the tokenizer with command-line arguments.
@@ -39,11 +47,12 @@ public:
     /// @details Searches for the specified option in the tokens. If found, it returns the next token as the value.
     inline const std::string &getOption(const std::string &option) const
     {
-        auto it = std::find(tokens.begin(), tokens.end(), option);
-        if (it != tokens.end() && isOption(*it)) {
-            ++it;
-            if (it != tokens.end() && !isOption(*it)) {
-                return *it;
+        this->buildIndex();
+        auto it = index.find(option);
+        if (it != index.end() && isOption(option)) {
+            std::size_t position = it->second + 1;
+            if (position < tokens.size() && !isOption(tokens[position])) {
+                return tokens[position];
             }
         }
         static const std::string empty_string;
@@ -56,10 +65,34 @@ public:
     /// @details Searches for the specified option in the tokens and returns whether it exists.
     inline bool hasOption(const std::string &option) const
     {
-        return std::find(tokens.begin(), tokens.end(), option) != tokens.end();
+        this->buildIndex();
+        return index.find(option) != index.end();
+    }
+
+    /// @brief Adds the memory used by the tokens and their index to the given report.
+    /// @param usage The report to update.
+    inline void getMemoryUsage(MemoryUsage &usage) const
+    {
+        usage.schema += sizeof(Tokenizer);
+        usage.values += heap_size(tokens);
+        usage.indices += heap_size(index);
+    }
+
+    /// @brief Returns the number of tokens.
+    /// @return The number of arguments, excluding the program name.
+    inline std::size_t size() const
+    {
+        return tokens.size();
+    }
+
+    /// @brief Returns the token in the given position.
+    /// @param position The position of the token, the program name excluded.
+    /// @return The token.
+    inline const std::string &getToken(std::size_t position) const
+    {
+        return tokens[position];
     }
 
-private:
     /// @brief Determines whether a token is an option.
     /// @param token The token to check.
     /// @return True if the token starts with '-', false otherwise.
@@ -69,6 +102,21 @@ private:
         return (!token.empty()) && (token[0] == '-') && !isNumber(token);
     }
 
+    /// @brief Indexes the first occurrence of every token, unless it was already done.
+    /// @details Called on first lookup, or eagerly before the tokenizer is read from several threads.
+    void buildIndex() const
+    {
+        if (!index.empty() || tokens.empty()) {
+            return;
+        }
+        index.reserve(tokens.size());
+        for (std::size_t i = 0; i < tokens.size(); ++i) {
+            index.emplace(tokens[i], i);
+        }
+    }
+
+private:
+
     /// @brief Determines whether a token represents a number.
     /// @param token The token to check.
     /// @return True if the token represents a number, false otherwise.
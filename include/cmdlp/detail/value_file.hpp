@@ -0,0 +1,209 @@
+/// @file value_file.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the set of allowed values loaded on demand from a file.
+
+#pragma once
+
+#include "memory_usage.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cmdlp::detail
+{
+
+/// @class ValueFile
+/// @brief The allowed values of a multi-option, one per line of a file.
+/// @details Nothing is read until a value is first checked or completed, so a
+/// list of many thousands of values only costs something to the invocations
+/// actually selecting one. The file is then mapped in memory (read, where
+/// mapping is not available) and the values are kept as views into it: a
+/// hash set answers membership, a sorted copy answers prefix searches.
+/// Empty lines are skipped and a trailing carriage return is ignored.
+/// The file is shared by the copies of the option, which may be parsed on
+/// different threads, so loading is serialized and happens only once.
+class ValueFile {
+public:
+    /// @brief Constructs a set backed by a file, without reading it.
+    /// @param _path The path of the file.
+    explicit ValueFile(std::string _path)
+        : path(std::move(_path)),
+          loaded(false),
+          mapping(nullptr),
+          mapping_size(0),
+          contents(),
+          values(),
+          sorted(),
+          mutex()
+    {
+    }
+
+    ValueFile(const ValueFile &)            = delete;
+    ValueFile &operator=(const ValueFile &) = delete;
+
+    /// @brief Releases the mapping of the file.
+    ~ValueFile()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        if (mapping) {
+            munmap(mapping, mapping_size);
+        }
+#endif
+    }
+
+    /// @brief Returns the path of the file.
+    inline const std::string &getPath() const
+    {
+        return path;
+    }
+
+    /// @brief Tells whether the file has been read.
+    inline bool isLoaded() const
+    {
+        return loaded.load(std::memory_order_acquire);
+    }
+
+    /// @brief Tells whether a value is listed in the file.
+    /// @param value The value.
+    /// @throws std::runtime_error if the file cannot be read.
+    bool contains(std::string_view value)
+    {
+        this->load();
+        return values.find(value) != values.end();
+    }
+
+    /// @brief Finds the values starting with a prefix.
+    /// @param prefix The prefix, empty to list all the values.
+    /// @return The values, sorted, viewing the contents of the file.
+    /// @throws std::runtime_error if the file cannot be read.
+    std::vector<std::string_view> complete(std::string_view prefix)
+    {
+        this->load();
+        std::vector<std::string_view> result;
+        for (auto it = std::lower_bound(sorted.begin(), sorted.end(), prefix); it != sorted.end(); ++it) {
+            if (it->substr(0, prefix.size()) != prefix) {
+                break;
+            }
+            result.push_back(*it);
+        }
+        return result;
+    }
+
+    /// @brief Returns the number of distinct values, loading the file if needed.
+    std::size_t size()
+    {
+        this->load();
+        return sorted.size();
+    }
+
+    /// @brief Adds the memory used by the indices to the given report.
+    /// @param usage The report to update.
+    /// @details The mapped file is not counted, it is not heap memory.
+    void getMemoryUsage(MemoryUsage &usage) const
+    {
+        usage.values += heap_size(path) + contents.capacity();
+        // Each node of the set holds the next pointer, the cached hash and the view.
+        const std::size_t node_size = sizeof(void *) + sizeof(std::size_t) + sizeof(std::string_view);
+        usage.indices += values.bucket_count() * sizeof(void *) + values.size() * node_size + sorted.capacity() * sizeof(std::string_view);
+    }
+
+private:
+    /// @brief Reads and indexes the file, once.
+    /// @throws std::runtime_error if the file cannot be read.
+    void load()
+    {
+        if (loaded.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (loaded.load(std::memory_order_relaxed)) {
+            return;
+        }
+        std::string_view text = this->read();
+        for (std::size_t begin = 0; begin < text.size();) {
+            const void *newline   = std::memchr(text.data() + begin, '\n', text.size() - begin);
+            std::size_t end       = newline ? static_cast<std::size_t>(static_cast<const char *>(newline) - text.data()) : text.size();
+            std::string_view line = text.substr(begin, end - begin);
+            if (!line.empty() && (line.back() == '\r')) {
+                line.remove_suffix(1);
+            }
+            if (!line.empty() && values.insert(line).second) {
+                sorted.push_back(line);
+            }
+            begin = end + 1;
+        }
+        std::sort(sorted.begin(), sorted.end());
+        loaded.store(true, std::memory_order_release);
+    }
+
+    /// @brief Maps the file in memory, or reads it where mapping is not available.
+    /// @return The contents of the file.
+    /// @throws std::runtime_error if the file cannot be read.
+    std::string_view read()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open the file of allowed values: " + path);
+        }
+        struct stat info;
+        if (fstat(fd, &info) < 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot read the file of allowed values: " + path);
+        }
+        if (info.st_size > 0) {
+            void *address = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map the file of allowed values: " + path);
+            }
+            mapping      = address;
+            mapping_size = static_cast<std::size_t>(info.st_size);
+        }
+        ::close(fd);
+        return std::string_view(static_cast<const char *>(mapping), mapping_size);
+#else
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Cannot open the file of allowed values: " + path);
+        }
+        contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return contents;
+#endif
+    }
+
+    /// @brief The path of the file.
+    const std::string path;
+    /// @brief Whether the file has been read and indexed, the indices are read-only afterwards.
+    std::atomic<bool> loaded;
+    /// @brief The mapped file, if any.
+    void *mapping;
+    /// @brief The size of the mapping.
+    std::size_t mapping_size;
+    /// @brief The contents of the file, where mapping is not available.
+    std::string contents;
+    /// @brief The values, viewing the contents of the file.
+    std::unordered_set<std::string_view> values;
+    /// @brief The same values, sorted.
+    std::vector<std::string_view> sorted;
+    /// @brief Serializes the loading of the file.
+    std::mutex mutex;
+};
+
+} // namespace cmdlp::detail
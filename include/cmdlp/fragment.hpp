@@ -0,0 +1,76 @@
+/// @file fragment.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the `Fragment` class, a table of options built apart from the `Parser`.
+
+#pragma once
+
+#include "detail/option_list.hpp"
+
+namespace cmdlp
+{
+
+/// @class Fragment
+/// @brief A standalone table of options, contributed to a `Parser` by a library or a plugin.
+/// @details A library builds its fragment once, possibly into a static
+/// variable, without knowing the other options of the program. The host then
+/// adds it with `Parser::merge`, which copies all its entries in one operation.
+/// Conflicts between the options of the same fragment are detected as they
+/// are added, conflicts with the parser when the fragment is merged.
+class Fragment {
+public:
+    /// @brief Constructs an empty fragment.
+    Fragment()
+        : options()
+    {
+    }
+
+    /// @brief Adds a value-based option to the fragment, see `Parser::addOption`.
+    template <typename T>
+    void addOption(const std::string &_opt_short,
+                   const std::string &_opt_long,
+                   const std::string &_description,
+                   const T &_value,
+                   bool _required)
+    {
+        options.addOption(new detail::ValueOption(_opt_short, _opt_long, _description, detail::format_value(_value), _required,
+                                                  &detail::validate_value<detail::value_type_t<T>>,
+                                                  &detail::equal_values<detail::value_type_t<T>>));
+    }
+
+    /// @brief Adds a toggle-based option to the fragment, see `Parser::addToggle`.
+    void addToggle(const std::string &_opt_short,
+                   const std::string &_opt_long,
+                   const std::string &_description,
+                   bool _toggled)
+    {
+        options.addOption(new detail::ToggleOption(_opt_short, _opt_long, _description, _toggled));
+    }
+
+    /// @brief Adds a multi-option to the fragment, see `Parser::addMultiOption`.
+    void addMultiOption(const std::string &_opt_short,
+                        const std::string &_opt_long,
+                        const std::string &_description,
+                        const std::vector<std::string> &_allowed_values,
+                        const std::string &_default_value)
+    {
+        options.addOption(new detail::MultiOption(_opt_short, _opt_long, _description, _allowed_values, _default_value));
+    }
+
+    /// @brief Adds a separator to the fragment, see `Parser::addSeparator`.
+    void addSeparator(const std::string &_description)
+    {
+        options.addOption(new detail::Separator(_description));
+    }
+
+    /// @brief Returns the options of the fragment.
+    inline const detail::OptionList &getOptions() const
+    {
+        return options;
+    }
+
+private:
+    /// @brief The options of the fragment.
+    detail::OptionList options;
+};
+
+} // namespace cmdlp
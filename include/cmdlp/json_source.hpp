@@ -0,0 +1,470 @@
+/// @file json_source.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines a configuration source reading the options from a JSON document, on demand.
+
+#pragma once
+
+#include "source.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace cmdlp
+{
+
+namespace detail
+{
+
+/// @class JsonScanner
+/// @brief Extracts the values of selected keys from a JSON document, without building it in memory.
+/// @details Only the objects on the way to a selected key are walked member
+/// by member. Any other value is skipped by jumping from one structural
+/// character to the next with `memchr` and `strpbrk`, which the C library
+/// implements with vector instructions. Strings are only unescaped when they
+/// are selected values or keys containing escapes.
+class JsonScanner {
+public:
+    /// @brief Constructs a scanner.
+    /// @param _text The document, which must be null-terminated (e.g., the data of a `std::string`).
+    /// @param _wanted Maps the dotted path of each selected key (e.g., "db.pool.size") to its option name.
+    /// @param _prefixes The dotted paths of the objects holding selected keys (e.g., "db" and "db.pool").
+    JsonScanner(std::string_view _text,
+                const std::unordered_map<std::string, std::string> &_wanted,
+                const std::unordered_set<std::string> &_prefixes)
+        : text(_text),
+          wanted(_wanted),
+          prefixes(_prefixes),
+          pos(0),
+          error()
+    {
+    }
+
+    /// @brief Scans the document, whose root must be an object.
+    /// @param settings The settings the selected values are appended to, the
+    /// elements of an array becoming one setting each.
+    /// @return False if the document cannot be read, see `getError` and `getPosition`.
+    bool scan(std::vector<ConfigSource::Setting> &settings)
+    {
+        std::string path;
+        this->skipSpace();
+        if (this->peek('{') && this->object(path, settings)) {
+            this->skipSpace();
+            if (pos == text.size()) {
+                return true;
+            }
+        }
+        if (error.empty()) {
+            error = "malformed JSON";
+        }
+        return false;
+    }
+
+    /// @brief Returns the position reached, where the error is when the scan fails.
+    inline std::size_t getPosition() const
+    {
+        return pos;
+    }
+
+    /// @brief Returns the description of the error, when the scan fails.
+    inline const std::string &getError() const
+    {
+        return error;
+    }
+
+private:
+    /// @brief Tells whether the next character is the given one.
+    inline bool peek(char c) const
+    {
+        return (pos < text.size()) && (text[pos] == c);
+    }
+
+    /// @brief Skips the white space.
+    inline void skipSpace()
+    {
+        while ((pos < text.size()) && ((text[pos] == ' ') || (text[pos] == '\n') || (text[pos] == '\r') || (text[pos] == '\t'))) {
+            ++pos;
+        }
+    }
+
+    /// @brief Walks the members of an object, descending only towards the selected keys.
+    /// @param path The dotted path of the object, restored before returning.
+    /// @param settings The settings to append to.
+    bool object(std::string &path, std::vector<ConfigSource::Setting> &settings)
+    {
+        ++pos;
+        this->skipSpace();
+        if (this->peek('}')) {
+            ++pos;
+            return true;
+        }
+        std::string key;
+        for (;;) {
+            this->skipSpace();
+            if (!this->peek('"') || !this->string(key)) {
+                return false;
+            }
+            this->skipSpace();
+            if (!this->peek(':')) {
+                return false;
+            }
+            ++pos;
+            this->skipSpace();
+            std::size_t length = path.size();
+            if (!path.empty()) {
+                path.push_back('.');
+            }
+            path += key;
+            // A key can both be selected and hold selected keys (e.g., "db" and
+            // "db.host"): an object is then walked, anything else extracted.
+            auto it = wanted.find(path);
+            if (this->peek('{') && (prefixes.find(path) != prefixes.end())) {
+                if (!this->object(path, settings)) {
+                    return false;
+                }
+            } else if (it != wanted.end()) {
+                if (!this->value(path, it->second, settings)) {
+                    return false;
+                }
+            } else if (!this->skip()) {
+                return false;
+            }
+            path.resize(length);
+            this->skipSpace();
+            if (this->peek(',')) {
+                ++pos;
+            } else if (this->peek('}')) {
+                ++pos;
+                return true;
+            } else {
+                return false;
+            }
+        }
+    }
+
+    /// @brief Extracts a selected value: a scalar, or an array of scalars.
+    /// @param key The dotted path of the key holding the value.
+    /// @param name The name of the option.
+    /// @param settings The settings to append to.
+    bool value(const std::string &key, const std::string &name, std::vector<ConfigSource::Setting> &settings)
+    {
+        if (!this->peek('[')) {
+            return this->scalar(key, name, settings);
+        }
+        ++pos;
+        this->skipSpace();
+        if (this->peek(']')) {
+            ++pos;
+            return true;
+        }
+        for (;;) {
+            this->skipSpace();
+            if (!this->scalar(key, name, settings)) {
+                return false;
+            }
+            this->skipSpace();
+            if (this->peek(',')) {
+                ++pos;
+            } else if (this->peek(']')) {
+                ++pos;
+                return true;
+            } else {
+                return false;
+            }
+        }
+    }
+
+    /// @brief Extracts a string, a number or a literal, `null` meaning no value.
+    /// @param key The dotted path of the key holding the value.
+    /// @param name The name of the option.
+    /// @param settings The settings to append to.
+    bool scalar(const std::string &key, const std::string &name, std::vector<ConfigSource::Setting> &settings)
+    {
+        if (this->peek('"')) {
+            std::string content;
+            if (!this->string(content)) {
+                return false;
+            }
+            settings.push_back(ConfigSource::Setting{ name, std::move(content) });
+            return true;
+        }
+        if (this->peek('{') || this->peek('[')) {
+            // Objects, and arrays nested in arrays, do not map to option values.
+            error = "unsupported value type for key \"" + key + "\"";
+            return false;
+        }
+        std::string_view token = this->token();
+        if (token.empty()) {
+            return false;
+        }
+        if (token != "null") {
+            settings.push_back(ConfigSource::Setting{ name, std::string(token) });
+        }
+        return true;
+    }
+
+    /// @brief Reads a number or a literal, up to the next delimiter.
+    std::string_view token()
+    {
+        std::size_t begin = pos;
+        while ((pos < text.size()) && !std::strchr(",]} \n\r\t", text[pos])) {
+            ++pos;
+        }
+        return text.substr(begin, pos - begin);
+    }
+
+    /// @brief Skips any value.
+    bool skip()
+    {
+        if (this->peek('"')) {
+            return this->skipString();
+        }
+        if (this->peek('{') || this->peek('[')) {
+            return this->skipContainer();
+        }
+        return !this->token().empty();
+    }
+
+    /// @brief Skips a string, jumping from one quote to the next.
+    bool skipString()
+    {
+        for (std::size_t from = pos + 1; from < text.size();) {
+            auto quote = static_cast<const char *>(std::memchr(text.data() + from, '"', text.size() - from));
+            if (!quote) {
+                break;
+            }
+            std::size_t end = static_cast<std::size_t>(quote - text.data());
+            // The quote is escaped if preceded by an odd number of backslashes.
+            std::size_t backslashes = 0;
+            while ((end - backslashes > pos + 1) && (text[end - backslashes - 1] == '\\')) {
+                ++backslashes;
+            }
+            if (backslashes % 2 == 0) {
+                pos = end + 1;
+                return true;
+            }
+            from = end + 1;
+        }
+        return false;
+    }
+
+    /// @brief Skips an object or an array, jumping from one structural character to the next.
+    /// @details Each closing bracket must match the innermost open one.
+    bool skipContainer()
+    {
+        // The closing brackets expected, innermost last.
+        std::string closers;
+        while (pos < text.size()) {
+            const char *next = std::strpbrk(text.data() + pos, "\"{}[]");
+            if (!next || (next >= text.data() + text.size())) {
+                return false;
+            }
+            pos = static_cast<std::size_t>(next - text.data());
+            if (*next == '"') {
+                if (!this->skipString()) {
+                    return false;
+                }
+                continue;
+            }
+            ++pos;
+            if ((*next == '{') || (*next == '[')) {
+                closers.push_back((*next == '{') ? '}' : ']');
+            } else if (closers.back() != *next) {
+                return false;
+            } else {
+                closers.pop_back();
+                if (closers.empty()) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /// @brief Reads a string, unescaping it if needed.
+    /// @param out The content of the string.
+    bool string(std::string &out)
+    {
+        std::size_t begin = pos + 1;
+        if (!this->skipString()) {
+            return false;
+        }
+        std::string_view raw = text.substr(begin, pos - 1 - begin);
+        if (raw.find('\\') == std::string_view::npos) {
+            out.assign(raw.data(), raw.size());
+            return true;
+        }
+        out.clear();
+        for (std::size_t i = 0; i < raw.size(); ++i) {
+            if (raw[i] != '\\') {
+                out.push_back(raw[i]);
+                continue;
+            }
+            if (++i == raw.size()) {
+                return false;
+            }
+            switch (raw[i]) {
+            case 'b':
+                out.push_back('\b');
+                break;
+            case 'f':
+                out.push_back('\f');
+                break;
+            case 'n':
+                out.push_back('\n');
+                break;
+            case 'r':
+                out.push_back('\r');
+                break;
+            case 't':
+                out.push_back('\t');
+                break;
+            case 'u': {
+                unsigned code = 0;
+                if (!JsonScanner::hex(raw, i + 1, code)) {
+                    return false;
+                }
+                i += 4;
+                // Combine a surrogate pair into a single code point.
+                unsigned low = 0;
+                if ((code >= 0xD800) && (code < 0xDC00) && (raw.substr(i + 1, 2) == "\\u") && JsonScanner::hex(raw, i + 3, low) && (low >= 0xDC00) && (low < 0xE000)) {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+                JsonScanner::utf8(code, out);
+                break;
+            }
+            default:
+                out.push_back(raw[i]);
+                break;
+            }
+        }
+        return true;
+    }
+
+    /// @brief Reads the four hexadecimal digits of a `\u` escape.
+    static bool hex(std::string_view raw, std::size_t begin, unsigned &code)
+    {
+        if (begin + 4 > raw.size()) {
+            return false;
+        }
+        code = 0;
+        for (std::size_t i = begin; i < begin + 4; ++i) {
+            char c = raw[i];
+            if ((c >= '0') && (c <= '9')) {
+                code = code * 16 + static_cast<unsigned>(c - '0');
+            } else if ((c >= 'a') && (c <= 'f')) {
+                code = code * 16 + static_cast<unsigned>(c - 'a' + 10);
+            } else if ((c >= 'A') && (c <= 'F')) {
+                code = code * 16 + static_cast<unsigned>(c - 'A' + 10);
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// @brief Appends a code point encoded in UTF-8.
+    static void utf8(unsigned code, std::string &out)
+    {
+        if (code < 0x80) {
+            out.push_back(static_cast<char>(code));
+        } else if (code < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+    }
+
+    /// @brief The document.
+    std::string_view text;
+    /// @brief The dotted paths of the selected keys, mapped to their option names.
+    const std::unordered_map<std::string, std::string> &wanted;
+    /// @brief The dotted paths of the objects holding selected keys.
+    const std::unordered_set<std::string> &prefixes;
+    /// @brief The position of the next character to read.
+    std::size_t pos;
+    /// @brief The description of the error, when the scan fails.
+    std::string error;
+};
+
+} // namespace detail
+
+/// @class JsonSource
+/// @brief Reads the options from a JSON document, looking up only their keys.
+/// @details The long name of an option, without its leading dashes, is the
+/// dotted path of its key: "--db.pool.size" is read from
+/// `{ "db": { "pool": { "size": 8 } } }`, or from `{ "db.pool.size": 8 }`.
+/// Strings, numbers and `true`/`false` are converted as if they were given
+/// on the command line, `null` leaves the option untouched, and each element
+/// of an array is a separate value, for tuple options. Keys of other tools
+/// are skipped without being parsed, so a large shared document costs little
+/// more than reading it.
+class JsonSource : public ConfigSource {
+public:
+    /// @brief Constructs a source reading a JSON file.
+    /// @param _path The path of the file.
+    /// @param _optional Whether a missing file is silently skipped.
+    explicit JsonSource(std::string _path, bool _optional = true)
+        : path(std::move(_path)),
+          optional(_optional)
+    {
+    }
+
+    virtual std::string name() const override
+    {
+        return path;
+    }
+
+    virtual void load(const detail::OptionList &options, std::vector<Setting> &settings) const override
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            if (optional) {
+                return;
+            }
+            throw std::runtime_error("Cannot open configuration file: " + path);
+        }
+        const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        // Select the keys of the registered options, and the objects leading to them.
+        std::unordered_map<std::string, std::string> wanted;
+        std::unordered_set<std::string> prefixes;
+        for (detail::OptionList::const_iterator_t it = options.begin(); it != options.end(); ++it) {
+            const std::string &opt_long = (*it)->opt_long;
+            std::size_t first           = opt_long.find_first_not_of('-');
+            if (first == std::string::npos) {
+                continue;
+            }
+            std::string key = opt_long.substr(first);
+            for (std::size_t dot = key.find('.'); dot != std::string::npos; dot = key.find('.', dot + 1)) {
+                prefixes.insert(key.substr(0, dot));
+            }
+            wanted.emplace(std::move(key), opt_long);
+        }
+        detail::JsonScanner scanner(text, wanted, prefixes);
+        if (!scanner.scan(settings)) {
+            throw std::invalid_argument(path + ": " + scanner.getError() + " near offset " + std::to_string(scanner.getPosition()));
+        }
+    }
+
+private:
+    /// @brief The path of the file.
+    std::string path;
+    /// @brief Whether a missing file is silently skipped.
+    bool optional;
+};
+
+} // namespace cmdlp
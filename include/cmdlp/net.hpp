@@ -0,0 +1,465 @@
+/// @file net.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines network address value types (IPv4/IPv6 addresses, CIDR prefixes, endpoints) and their `value_traits`.
+
+#pragma once
+
+#include "value_traits.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace cmdlp::net
+{
+
+/// @struct Address
+/// @brief An IPv4 or IPv6 address, in binary form.
+/// @details The bytes are in network order: an IPv4 address uses the first
+/// four, with the layout of `in_addr`, an IPv6 address all sixteen, with the
+/// layout of `in6_addr`, so they can be copied into them with `memcpy`.
+struct Address {
+    /// @brief The address family.
+    enum class Family : std::uint8_t {
+        ipv4, ///< Four bytes.
+        ipv6  ///< Sixteen bytes.
+    };
+
+    /// @brief The family of the address.
+    Family family = Family::ipv4;
+    /// @brief The bytes of the address, in network order, unused ones are zero.
+    std::array<std::uint8_t, 16> bytes = {};
+
+    /// @brief Returns the number of bytes used by the family.
+    inline std::size_t size() const
+    {
+        return (family == Family::ipv4) ? 4 : 16;
+    }
+
+    /// @brief Returns the number of bits used by the family.
+    inline std::size_t bits() const
+    {
+        return this->size() * 8;
+    }
+
+    /// @brief Returns a copy keeping only the first bits of the address.
+    /// @param length The number of bits to keep.
+    inline Address masked(std::size_t length) const
+    {
+        Address result = *this;
+        for (std::size_t i = 0; i < result.bytes.size(); ++i) {
+            std::size_t kept = (length > i * 8) ? std::min<std::size_t>(length - i * 8, 8) : 0;
+            result.bytes[i]  = static_cast<std::uint8_t>(result.bytes[i] & (0xFF00U >> kept));
+        }
+        return result;
+    }
+
+    inline bool operator==(const Address &other) const
+    {
+        return (family == other.family) && (bytes == other.bytes);
+    }
+
+    inline bool operator!=(const Address &other) const
+    {
+        return !(*this == other);
+    }
+
+    inline bool operator<(const Address &other) const
+    {
+        return std::tie(family, bytes) < std::tie(other.family, other.bytes);
+    }
+};
+
+/// @struct Prefix
+/// @brief A CIDR prefix (e.g., "10.0.0.0/8"), an address and the number of leading bits that matter.
+struct Prefix {
+    /// @brief The address, as written.
+    Address address;
+    /// @brief The number of leading bits, up to 32 for IPv4 and 128 for IPv6.
+    std::uint8_t length = 0;
+
+    /// @brief Tells whether an address falls within the prefix.
+    /// @param other The address.
+    inline bool contains(const Address &other) const
+    {
+        return (other.family == address.family) && (other.masked(length) == address.masked(length));
+    }
+};
+
+/// @struct Endpoint
+/// @brief An address and a port (e.g., "10.0.0.1:80" or "[::1]:80").
+struct Endpoint {
+    /// @brief The address.
+    Address address;
+    /// @brief The port.
+    std::uint16_t port = 0;
+};
+
+/// @class PrefixTable
+/// @brief A set of prefixes, such as an allow-list, answering membership queries.
+/// @details The prefixes are masked and sorted once. A query masks the address
+/// to each prefix length in use and binary-searches the table, so it costs
+/// one search per distinct length, regardless of the number of prefixes.
+class PrefixTable {
+public:
+    /// @brief Constructs an empty table.
+    PrefixTable()
+        : prefixes(),
+          lengths()
+    {
+    }
+
+    /// @brief Constructs a table from a range of prefixes.
+    /// @tparam Iterator An iterator over `Prefix` values.
+    /// @param first The first prefix.
+    /// @param last The end of the range.
+    template <typename Iterator>
+    PrefixTable(Iterator first, Iterator last)
+        : PrefixTable()
+    {
+        for (; first != last; ++first) {
+            this->insert(*first);
+        }
+    }
+
+    /// @brief Constructs a table from the tuples of a tuple option (e.g., `getTuples<net::Prefix>`).
+    /// @param tuples The tuples, holding one prefix each.
+    explicit PrefixTable(const std::vector<std::tuple<Prefix>> &tuples)
+        : PrefixTable()
+    {
+        for (const std::tuple<Prefix> &tuple : tuples) {
+            this->insert(std::get<0>(tuple));
+        }
+    }
+
+    /// @brief Adds a prefix to the table.
+    /// @param prefix The prefix, its host bits are ignored.
+    void insert(const Prefix &prefix)
+    {
+        Entry entry{ prefix.address.family, prefix.length, prefix.address.masked(prefix.length) };
+        auto it = std::lower_bound(prefixes.begin(), prefixes.end(), entry);
+        if ((it == prefixes.end()) || (entry < *it)) {
+            prefixes.insert(it, entry);
+        }
+        auto key = std::make_pair(prefix.address.family, prefix.length);
+        auto at  = std::lower_bound(lengths.begin(), lengths.end(), key);
+        if ((at == lengths.end()) || (*at != key)) {
+            lengths.insert(at, key);
+        }
+    }
+
+    /// @brief Tells whether an address falls within any of the prefixes.
+    /// @param address The address.
+    bool contains(const Address &address) const
+    {
+        for (const auto &key : lengths) {
+            if (key.first != address.family) {
+                continue;
+            }
+            Entry entry{ key.first, key.second, address.masked(key.second) };
+            if (std::binary_search(prefixes.begin(), prefixes.end(), entry)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Returns the number of distinct prefixes.
+    inline std::size_t size() const
+    {
+        return prefixes.size();
+    }
+
+private:
+    /// @brief A masked prefix, ordered by family, length and address.
+    struct Entry {
+        /// @brief The family of the prefix.
+        Address::Family family;
+        /// @brief The number of leading bits.
+        std::uint8_t length;
+        /// @brief The address, with the host bits cleared.
+        Address address;
+
+        inline bool operator<(const Entry &other) const
+        {
+            return std::tie(family, length, address.bytes) < std::tie(other.family, other.length, other.address.bytes);
+        }
+    };
+
+    /// @brief The masked prefixes, sorted.
+    std::vector<Entry> prefixes;
+    /// @brief The pairs of family and length in use, sorted.
+    std::vector<std::pair<Address::Family, std::uint8_t>> lengths;
+};
+
+namespace detail
+{
+
+/// @brief Parses a dotted-quad IPv4 address (e.g., "10.0.0.1").
+/// @param text The text.
+/// @param bytes The four bytes to fill.
+/// @return False if the text is not a valid address.
+inline bool parse_ipv4(std::string_view text, std::uint8_t *bytes)
+{
+    std::size_t part = 0, i = 0;
+    while (part < 4) {
+        std::size_t digits = 0;
+        unsigned value     = 0;
+        while ((i < text.size()) && (text[i] >= '0') && (text[i] <= '9') && (digits < 3)) {
+            value = value * 10 + static_cast<unsigned>(text[i++] - '0');
+            ++digits;
+        }
+        if ((digits == 0) || (value > 255)) {
+            return false;
+        }
+        bytes[part++] = static_cast<std::uint8_t>(value);
+        if (part < 4) {
+            if ((i == text.size()) || (text[i] != '.')) {
+                return false;
+            }
+            ++i;
+        }
+    }
+    return i == text.size();
+}
+
+/// @brief Parses an IPv6 address (e.g., "2001:db8::1" or "::ffff:10.0.0.1").
+/// @param text The text.
+/// @param bytes The sixteen bytes to fill.
+/// @return False if the text is not a valid address.
+inline bool parse_ipv6(std::string_view text, std::uint8_t *bytes)
+{
+    std::uint8_t parsed[16] = {};
+    std::size_t count = 0, i = 0, gap = 0;
+    // Whether the text holds a "::", at byte gap.
+    bool compressed = false;
+    if ((text.size() >= 2) && (text[0] == ':') && (text[1] == ':')) {
+        compressed = true;
+        i          = 2;
+    }
+    while (i < text.size()) {
+        // A group holding dots is an IPv4 address, which can only end the text.
+        std::string_view rest = text.substr(i);
+        if (rest.substr(0, rest.find(':')).find('.') != std::string_view::npos) {
+            if ((count > 12) || !parse_ipv4(rest, parsed + count)) {
+                return false;
+            }
+            count += 4;
+            break;
+        }
+        unsigned value     = 0;
+        std::size_t digits = 0;
+        for (; (i < text.size()) && (digits < 4) && std::isxdigit(static_cast<unsigned char>(text[i])); ++i, ++digits) {
+            char c = static_cast<char>(std::tolower(static_cast<unsigned char>(text[i])));
+            value  = value * 16 + static_cast<unsigned>((c <= '9') ? (c - '0') : (c - 'a' + 10));
+        }
+        if ((digits == 0) || (count >= 16)) {
+            return false;
+        }
+        parsed[count++] = static_cast<std::uint8_t>(value >> 8);
+        parsed[count++] = static_cast<std::uint8_t>(value & 0xFF);
+        if (i == text.size()) {
+            break;
+        }
+        if ((text[i] != ':') || (++i == text.size())) {
+            return false;
+        }
+        if (text[i] == ':') {
+            // A second "::", or one standing for no group at all.
+            if (compressed || (count == 16)) {
+                return false;
+            }
+            compressed = true;
+            gap        = count;
+            ++i;
+        }
+    }
+    if (compressed ? (count > 14) : (count != 16)) {
+        return false;
+    }
+    // Expand the gap with zeros.
+    std::size_t tail = compressed ? (count - gap) : 0;
+    std::fill(bytes, bytes + 16, 0);
+    std::copy(parsed, parsed + (count - tail), bytes);
+    std::copy(parsed + (count - tail), parsed + count, bytes + 16 - tail);
+    return true;
+}
+
+/// @brief Parses an IPv4 or IPv6 address.
+/// @param text The text.
+/// @param address The address to fill.
+/// @return False if the text is not a valid address.
+inline bool parse_address(std::string_view text, Address &address)
+{
+    Address result;
+    if (text.find(':') != std::string_view::npos) {
+        result.family = Address::Family::ipv6;
+        if (!parse_ipv6(text, result.bytes.data())) {
+            return false;
+        }
+    } else if (!parse_ipv4(text, result.bytes.data())) {
+        return false;
+    }
+    address = result;
+    return true;
+}
+
+/// @brief Formats an address, IPv6 ones in the canonical form of RFC 5952.
+/// @param address The address.
+/// @param out The buffer, at least 40 characters long.
+/// @return The number of characters written, without terminator.
+inline std::size_t format_address(const Address &address, char *out)
+{
+    static const char hex[] = "0123456789abcdef";
+    std::size_t length      = 0;
+    if (address.family == Address::Family::ipv4) {
+        for (std::size_t i = 0; i < 4; ++i) {
+            if (i > 0) {
+                out[length++] = '.';
+            }
+            length += cmdlp::value_traits<unsigned>::format(address.bytes[i], out + length, 4);
+        }
+        return length;
+    }
+    std::uint16_t groups[8];
+    for (std::size_t i = 0; i < 8; ++i) {
+        groups[i] = static_cast<std::uint16_t>((address.bytes[2 * i] << 8) | address.bytes[2 * i + 1]);
+    }
+    // Find the longest run of at least two zero groups, the first one on ties.
+    std::size_t best = 8, best_length = 1;
+    for (std::size_t i = 0; i < 8;) {
+        std::size_t j = i;
+        while ((j < 8) && (groups[j] == 0)) {
+            ++j;
+        }
+        if (j - i > best_length) {
+            best        = i;
+            best_length = j - i;
+        }
+        i = (j > i) ? j : (i + 1);
+    }
+    for (std::size_t i = 0; i < 8; ++i) {
+        if (i == best) {
+            out[length++] = ':';
+            out[length++] = ':';
+            i += best_length - 1;
+            continue;
+        }
+        if ((i > 0) && (i != best + best_length)) {
+            out[length++] = ':';
+        }
+        bool started = false;
+        for (int shift = 12; shift >= 0; shift -= 4) {
+            unsigned nibble = (groups[i] >> shift) & 0xFU;
+            if (started || (nibble != 0) || (shift == 0)) {
+                out[length++] = hex[nibble];
+                started       = true;
+            }
+        }
+    }
+    return length;
+}
+
+} // namespace detail
+
+} // namespace cmdlp::net
+
+namespace cmdlp
+{
+
+/// @brief Converts IPv4 and IPv6 addresses, without allocating nor resolving names.
+template <>
+struct value_traits<net::Address> {
+    static bool parse(std::string_view text, net::Address &value)
+    {
+        return net::detail::parse_address(text, value);
+    }
+
+    static std::size_t format(const net::Address &value, char *buffer, std::size_t size)
+    {
+        char text[40];
+        return detail::copy_to_buffer(text, net::detail::format_address(value, text), buffer, size);
+    }
+};
+
+/// @brief Converts CIDR prefixes, an address alone stands for a single host.
+template <>
+struct value_traits<net::Prefix> {
+    static bool parse(std::string_view text, net::Prefix &value)
+    {
+        std::size_t slash = text.find('/');
+        net::Prefix result;
+        if (!net::detail::parse_address(text.substr(0, slash), result.address)) {
+            return false;
+        }
+        result.length = static_cast<std::uint8_t>(result.address.bits());
+        if (slash != std::string_view::npos) {
+            unsigned length = 0;
+            if (!value_traits<unsigned>::parse(text.substr(slash + 1), length) || (length > result.address.bits())) {
+                return false;
+            }
+            result.length = static_cast<std::uint8_t>(length);
+        }
+        value = result;
+        return true;
+    }
+
+    static std::size_t format(const net::Prefix &value, char *buffer, std::size_t size)
+    {
+        char text[48];
+        std::size_t length = net::detail::format_address(value.address, text);
+        text[length++]     = '/';
+        length += value_traits<unsigned>::format(value.length, text + length, sizeof(text) - length);
+        return detail::copy_to_buffer(text, length, buffer, size);
+    }
+};
+
+/// @brief Converts endpoints, IPv6 addresses are enclosed in brackets (e.g., "[::1]:80").
+template <>
+struct value_traits<net::Endpoint> {
+    static bool parse(std::string_view text, net::Endpoint &value)
+    {
+        std::size_t colon = text.rfind(':');
+        if (colon == std::string_view::npos) {
+            return false;
+        }
+        std::string_view host = text.substr(0, colon);
+        if ((host.size() >= 2) && (host.front() == '[') && (host.back() == ']')) {
+            host = host.substr(1, host.size() - 2);
+            if (host.find(':') == std::string_view::npos) {
+                return false;
+            }
+        } else if (host.find(':') != std::string_view::npos) {
+            return false;
+        }
+        net::Endpoint result;
+        if (!net::detail::parse_address(host, result.address) || !value_traits<std::uint16_t>::parse(text.substr(colon + 1), result.port)) {
+            return false;
+        }
+        value = result;
+        return true;
+    }
+
+    static std::size_t format(const net::Endpoint &value, char *buffer, std::size_t size)
+    {
+        char text[56];
+        std::size_t length = 0;
+        bool ipv6          = (value.address.family == net::Address::Family::ipv6);
+        if (ipv6) {
+            text[length++] = '[';
+        }
+        length += net::detail::format_address(value.address, text + length);
+        if (ipv6) {
+            text[length++] = ']';
+        }
+        text[length++] = ':';
+        length += value_traits<std::uint16_t>::format(value.port, text + length, sizeof(text) - length);
+        return detail::copy_to_buffer(text, length, buffer, size);
+    }
+};
+
+} // namespace cmdlp
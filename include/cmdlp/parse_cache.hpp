@@ -0,0 +1,204 @@
+/// @file parse_cache.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines a cache of parse results, for command lines that are parsed over and over.
+
+#pragma once
+
+#include "detail/hash.hpp"
+#include "parser.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace cmdlp
+{
+
+/// @class ParseCache
+/// @brief A least-recently-used cache of parse results.
+/// @details Results are keyed by a hash of the arguments and by the fingerprint
+/// of the options they were parsed against. The arguments are stored alongside
+/// each result and compared on lookup, so hash collisions never return the
+/// wrong result. The cache can be shared between threads, as long as the
+/// schema is not modified meanwhile; its `Parser::fingerprint` is computed
+/// under the lock of the cache, so the schema must not be shared with other
+/// caches used concurrently.
+///
+/// The results are copies of the schema without its observers, which are
+/// thus never notified by the cache, and with the values that the schema
+/// loaded from its sources. Live values changed at runtime are left out, and
+/// loading the sources again invalidates the results parsed before. The
+/// results do not report to the tracing sink of the schema, which may not
+/// be safe to use from several threads. Everything a parser computes on first read is
+/// computed before a result is published (see `Parser::precompute`), so
+/// the results are not modified by reads.
+class ParseCache {
+public:
+    /// @brief A parse result, shared between all the lookups that hit it.
+    /// @details It can be read concurrently, but must not be modified.
+    using result_t = std::shared_ptr<const Parser>;
+    /// @brief Hashes the arguments, program name excluded, starting from the fingerprint of the schema.
+    using hash_t = uint64_t (*)(uint64_t fingerprint, int argc, char **argv);
+
+    /// @brief Constructs an empty cache.
+    /// @param _capacity The maximum number of results kept, zero disables caching.
+    /// @param _hash The hash of the arguments, FNV-1a by default.
+    explicit ParseCache(std::size_t _capacity, hash_t _hash = &ParseCache::hashArguments)
+        : capacity(_capacity),
+          hash(_hash),
+          entries(),
+          index(),
+          hits(0),
+          misses(0),
+          mutex()
+    {
+    }
+
+    /// @brief Parses the arguments against the options of `schema`, or returns the cached result.
+    /// @param schema The parser holding the registered options and their defaults.
+    /// @param argc The number of command-line arguments.
+    /// @param argv The array of command-line arguments.
+    /// @return A parser with the arguments already parsed.
+    /// @throws std::logic_error if the schema has sources that were not loaded yet.
+    /// @details On a miss, the schema is copied and the arguments are parsed into
+    /// the copy, which is then stored. The program name is not part of the key.
+    result_t parse(const Parser &schema, int argc, char **argv)
+    {
+        if (!schema.sources.empty() && !schema.sources_loaded) {
+            throw std::logic_error("Load the sources of the schema before caching its parse results");
+        }
+        uint64_t fingerprint, key;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            // Computing the fingerprint caches it into the schema.
+            fingerprint = schema.fingerprint();
+            key         = hash(fingerprint, argc, argv);
+            auto it     = index.find(key);
+            if ((it != index.end()) && ParseCache::matches(*it->second, fingerprint, argc, argv)) {
+                // Move the entry to the front of the list.
+                entries.splice(entries.begin(), entries, it->second);
+                ++hits;
+                return it->second->result;
+            }
+            ++misses;
+        }
+        std::shared_ptr<Parser> result(new Parser(schema, Parser::Detached{}));
+        result->setArguments(argc, argv);
+        result->parseOptions();
+        result->precompute();
+        if (capacity > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = index.find(key);
+            if (it != index.end()) {
+                entries.erase(it->second);
+                index.erase(it);
+            }
+            entries.push_front(Entry{ key, fingerprint, std::vector<std::string>(argv + std::min(argc, 1), argv + argc), result });
+            index[key] = entries.begin();
+            if (entries.size() > capacity) {
+                index.erase(entries.back().key);
+                entries.pop_back();
+            }
+        }
+        return result;
+    }
+
+    /// @brief Removes all the cached results.
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        index.clear();
+    }
+
+    /// @brief Returns the number of cached results.
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+    /// @brief Returns the number of lookups that returned a cached result.
+    std::size_t getHits() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return hits;
+    }
+
+    /// @brief Returns the number of lookups that required parsing.
+    std::size_t getMisses() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return misses;
+    }
+
+    /// @brief Hashes the arguments with FNV-1a, each one with its terminator.
+    /// @param fingerprint The fingerprint of the schema, used as the seed.
+    /// @param argc The number of command-line arguments.
+    /// @param argv The array of command-line arguments.
+    /// @return The key of the arguments.
+    static uint64_t hashArguments(uint64_t fingerprint, int argc, char **argv)
+    {
+        uint64_t key = fingerprint;
+        for (int i = 1; i < argc; ++i) {
+            key = detail::fnv1a(argv[i], std::strlen(argv[i]) + 1, key);
+        }
+        return key;
+    }
+
+private:
+    /// @brief A cached result, with what is needed to verify a lookup.
+    struct Entry {
+        /// @brief The key under which the entry is indexed.
+        uint64_t key;
+        /// @brief The fingerprint of the schema the result was parsed against.
+        uint64_t fingerprint;
+        /// @brief The arguments, program name excluded.
+        std::vector<std::string> arguments;
+        /// @brief The parse result.
+        result_t result;
+    };
+
+    /// @brief Alias for the list of entries, most recently used first.
+    using entry_list_t = std::list<Entry>;
+
+    /// @brief Checks that a cached entry was produced by the same schema and arguments.
+    /// @param entry The cached entry.
+    /// @param fingerprint The fingerprint of the schema of the lookup.
+    /// @param argc The number of command-line arguments.
+    /// @param argv The array of command-line arguments.
+    /// @return True if the entry can be returned.
+    static bool matches(const Entry &entry, uint64_t fingerprint, int argc, char **argv)
+    {
+        if ((entry.fingerprint != fingerprint) || (entry.arguments.size() + 1 != static_cast<std::size_t>(std::max(argc, 1)))) {
+            return false;
+        }
+        for (std::size_t i = 0; i < entry.arguments.size(); ++i) {
+            if (entry.arguments[i] != argv[i + 1]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// @brief The maximum number of cached results.
+    const std::size_t capacity;
+    /// @brief The hash of the arguments.
+    const hash_t hash;
+    /// @brief The cached results, most recently used first.
+    entry_list_t entries;
+    /// @brief Maps the keys to their entry.
+    std::unordered_map<uint64_t, entry_list_t::iterator> index;
+    /// @brief The number of lookups that returned a cached result.
+    std::size_t hits;
+    /// @brief The number of lookups that required parsing.
+    std::size_t misses;
+    /// @brief Protects the entries, the index and the statistics.
+    mutable std::mutex mutex;
+};
+
+} // namespace cmdlp
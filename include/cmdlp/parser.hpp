@@ -7,27 +7,292 @@
 #include "detail/tokenizer.hpp"
 #include "detail/option.hpp"
 #include "detail/option_list.hpp"
+#include "detail/hash.hpp"
+#include "detail/help_index.hpp"
+#include "detail/parse_event.hpp"
+#include "detail/signal_table.hpp"
+#include "fragment.hpp"
+#include "source.hpp"
+#include "trace.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <sstream>
+#include <system_error>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
 
 namespace cmdlp
 {
 
+/// @brief Where the current value of an option comes from.
+enum class ValueOrigin {
+    default_value, ///< The value given when the option was registered.
+    source,        ///< A configuration source (see `Parser::addSource`).
+    profile,       ///< The selected profile.
+    command_line,  ///< The command-line arguments.
+    derived,       ///< A derivation (see `Parser::addDerivation`).
+    runtime        ///< `Parser::setLiveValue`, for live options.
+};
+
+/// @brief The formats of `Parser::writeEffectiveConfig`.
+enum class ConfigFormat {
+    lines, ///< One "name = value" line per option, readable by `FileSource`.
+    json   ///< A flat JSON object, readable by `JsonSource`.
+};
+
+/// @class Live
+/// @brief A handle reading a live option, see `Parser::addLiveOption`.
+/// @tparam T The type of the value.
+/// @details Reading is a relaxed atomic load, so worker threads can poll the
+/// value in their hot loops while a control thread changes it. The handle
+/// remains valid as long as the parser that returned it.
+template <typename T>
+class Live {
+public:
+    /// @brief Constructs a handle to the value of an option.
+    /// @param _value The atomic holding the value.
+    explicit Live(const std::atomic<T> *_value)
+        : value(_value)
+    {
+    }
+
+    /// @brief Returns the current value.
+    inline T load() const noexcept
+    {
+        return value->load(std::memory_order_relaxed);
+    }
+
+private:
+    /// @brief The atomic holding the value.
+    const std::atomic<T> *value;
+};
+
+class Parser;
+
+/// @class Handle
+/// @brief A handle reading an option without looking up its name, see `Parser::getHandle`.
+/// @tparam T The type of the value, string options are read as views.
+/// @details The handle remains valid as long as the parser that returned it.
+/// A view of a string option points into the option, and remains valid until
+/// the options are parsed or reset again.
+template <typename T>
+class Handle {
+public:
+    /// @brief The type returned by `get`: a view for string options, `T` otherwise.
+    using value_t = std::conditional_t<std::is_same_v<T, std::string>, std::string_view, T>;
+
+    /// @brief Constructs a handle to an option.
+    /// @param _parser The parser holding the option.
+    /// @param _slot The slot of the option.
+    Handle(const Parser *_parser, std::size_t _slot)
+        : parser(_parser),
+          slot(_slot)
+    {
+    }
+
+    /// @brief Returns the current value.
+    inline value_t get() const;
+
+private:
+    /// @brief The parser holding the option.
+    const Parser *parser;
+    /// @brief The slot of the option.
+    std::size_t slot;
+};
+
 /// @class Parser
 /// @brief A class to define, parse, and manage command-line options.
 class Parser {
 public:
+    /// @brief Receives the slots of the observed options whose value changed, in slot order.
+    using observer_t = std::function<void(const std::vector<std::size_t> &)>;
+
+    /// @class Namespace
+    /// @brief Registers options under a dotted prefix (e.g., "--size" as "--db.pool.size").
+    /// @details Obtained from `Parser::addNamespace`, it must not outlive the parser.
+    /// Short names are registered as given.
+    class Namespace {
+    public:
+        /// @brief Constructs a namespace of the given parser.
+        /// @param _parser The parser the options are added to.
+        /// @param _prefix The prefix, without leading dashes (e.g., "db.pool").
+        Namespace(Parser &_parser, std::string _prefix)
+            : parser(_parser),
+              prefix(std::move(_prefix))
+        {
+        }
+
+        /// @brief Returns the prefix of the namespace.
+        inline const std::string &getPrefix() const
+        {
+            return prefix;
+        }
+
+        /// @brief Returns the nested namespace with the given name.
+        /// @param name The name of the nested namespace (e.g., "pool").
+        inline Namespace addNamespace(const std::string &name) const
+        {
+            return Namespace(parser, prefix + "." + name);
+        }
+
+        /// @brief Adds a value-based option to the namespace, see `Parser::addOption`.
+        template <typename T>
+        void addOption(const std::string &_opt_short,
+                       const std::string &_opt_long,
+                       const std::string &_description,
+                       const T &_value,
+                       bool _required)
+        {
+            parser.addOption(_opt_short, this->qualify(_opt_long), _description, _value, _required);
+        }
+
+        /// @brief Adds a toggle-based option to the namespace, see `Parser::addToggle`.
+        void addToggle(const std::string &_opt_short,
+                       const std::string &_opt_long,
+                       const std::string &_description,
+                       bool _toggled)
+        {
+            parser.addToggle(_opt_short, this->qualify(_opt_long), _description, _toggled);
+        }
+
+        /// @brief Adds a multi-option to the namespace, see `Parser::addMultiOption`.
+        void addMultiOption(const std::string &_opt_short,
+                            const std::string &_opt_long,
+                            const std::string &_description,
+                            const std::vector<std::string> &_allowed_values,
+                            const std::string &_default_value)
+        {
+            parser.addMultiOption(_opt_short, this->qualify(_opt_long), _description, _allowed_values, _default_value);
+        }
+
+    private:
+        /// @brief Prepends the prefix to a long name.
+        /// @param opt_long The long name (e.g., "--size").
+        /// @return The qualified long name (e.g., "--db.pool.size").
+        std::string qualify(const std::string &opt_long) const
+        {
+            return "--" + prefix + "." + opt_long.substr(std::min(opt_long.find_first_not_of('-'), opt_long.size()));
+        }
+
+        /// @brief The parser the options are added to.
+        Parser &parser;
+        /// @brief The prefix, without leading dashes.
+        std::string prefix;
+    };
+
     /// @brief Constructs an `Parser` object.
     /// @param argc The number of command-line arguments.
     /// @param argv The array of command-line arguments.
+    /// @param _tracer An optional sink receiving the tracing events of the parser.
     /// @details Initializes the tokenizer and the option list.
-    Parser(int argc, char **argv)
-        : tokenizer(argc, argv),
+    Parser(int argc, char **argv, TraceSink *_tracer = nullptr)
+        : tracer(_tracer),
+          registering(false),
+          tokenizer(Parser::tokenize(_tracer, argc, argv)),
           options(),
-          option_parsed(false)
+          option_parsed(false),
+          schema_fingerprint(0),
+          profile_slot(detail::OptionList::npos),
+          derivations(),
+          subscriptions(),
+          help_index(),
+          signal_table(),
+          sources(),
+          source_values(),
+          sources_loaded(false),
+          origins()
+    {
+#ifdef CMDLP_ACCESS_STATS
+        // Constructs the report first, so that it is written after the static parsers are destroyed.
+        detail::AccessReport::instance();
+#endif
+    }
+
+    /// @brief Copy constructor.
+    /// @param other The `Parser` to copy.
+    /// @details Copies the arguments and deep copies the options, the tracing sink is shared.
+    Parser(const Parser &other)
+        : tracer(other.tracer),
+          registering(false),
+          tokenizer(other.tokenizer),
+          options(other.options),
+          option_parsed(other.option_parsed),
+          schema_fingerprint(other.schema_fingerprint),
+          profile_slot(other.profile_slot),
+          derivations(other.derivations),
+          subscriptions(other.subscriptions),
+          help_index(),
+          signal_table(other.signal_table),
+          sources(other.sources),
+          source_values(other.source_values),
+          sources_loaded(other.sources_loaded),
+          origins(other.origins)
+    {
+    }
+
+    /// @brief Computes everything that is otherwise computed on first read.
+    /// @details Evaluates the derived options, and builds the index of the
+    /// arguments, the help search index and the fingerprint. Afterwards, the
+    /// parser can be read from several threads at once, as long as none of
+    /// them modifies it.
+    void precompute() const
     {
+        this->endRegistration();
+        for (const auto &derivation : derivations) {
+            this->evaluate(derivation.first);
+        }
+        tokenizer.buildIndex();
+        if (help_index.empty()) {
+            help_index.build(options);
+        }
+        this->fingerprint();
+    }
+
+    /// @brief Copy assignment is disabled, use the copy constructor instead.
+    Parser &operator=(const Parser &) = delete;
+
+    /// @brief Destructor.
+    /// @details Closes the registration phase, if it is still being traced. When
+    /// built with `CMDLP_ACCESS_STATS`, it also hands the access counters over to
+    /// the report dumped to `std::cerr` at exit, once for the parser and its copies.
+    ~Parser()
+    {
+        this->endRegistration();
+#ifdef CMDLP_ACCESS_STATS
+        for (detail::OptionList::const_iterator_t it = options.begin(); it != options.end(); ++it) {
+            if (!dynamic_cast<const detail::Separator *>(*it)) {
+                detail::AccessReport::instance().collect((*it)->opt_long, (*it)->stats);
+            }
+        }
+#endif
+    }
+
+    /// @brief Replaces the command-line arguments the options are parsed from.
+    /// @param argc The number of command-line arguments.
+    /// @param argv The array of command-line arguments.
+    /// @details Options keep their current values, call `parseOptions` to apply the new arguments.
+    void setArguments(int argc, char **argv)
+    {
+        tokenizer     = Parser::tokenize(tracer, argc, argv);
+        option_parsed = false;
+    }
+
+    /// @brief Installs the sink receiving the tracing events.
+    /// @param _tracer The sink, or `nullptr` to disable tracing.
+    /// @details The sink is not owned by the parser, and must outlive it.
+    void setTraceSink(TraceSink *_tracer)
+    {
+        this->endRegistration();
+        tracer = _tracer;
     }
 
     /// @brief Adds a multi-value option to the parser.
@@ -43,10 +308,36 @@ public:
                         const std::vector<std::string> &_allowed_values,
                         const std::string &_default_value)
     {
+        this->beginRegistration();
         // Create the MultiOption.
         auto option = new detail::MultiOption(_opt_short, _opt_long, _description, _allowed_values, _default_value);
         // Add the option to the list.
         options.addOption(option);
+        schema_fingerprint = 0;
+    }
+
+    /// @brief Adds a multi-option whose allowed values are listed in a file, one per line.
+    /// @param _opt_short The short version of the option (e.g., "-m").
+    /// @param _opt_long The long version of the option (e.g., "--model").
+    /// @param _description A description of the option, displayed in the help text.
+    /// @param _path The path of the file listing the allowed values.
+    /// @param _default_value The default value for the option, which is not checked.
+    /// @details The file is only read, and indexed, the first time a value is
+    /// selected or completed, so invocations not using the option never pay
+    /// for it. A file that cannot be read is then reported by throwing
+    /// `std::runtime_error`.
+    void addMultiOptionFromFile(const std::string &_opt_short,
+                                const std::string &_opt_long,
+                                const std::string &_description,
+                                const std::string &_path,
+                                const std::string &_default_value)
+    {
+        this->beginRegistration();
+        // Create the MultiOption, without reading the file.
+        auto option = new detail::MultiOption(_opt_short, _opt_long, _description, std::make_shared<detail::ValueFile>(_path), _default_value);
+        // Add the option to the list.
+        options.addOption(option);
+        schema_fingerprint = 0;
     }
 
     /// @brief Adds a value-based option to the parser.
@@ -63,13 +354,14 @@ public:
                    const T &_value,
                    bool _required)
     {
-        // Turn the value to string.
-        std::stringstream ss;
-        ss << _value;
-        // Create the option.
-        auto option = new detail::ValueOption(_opt_short, _opt_long, _description, ss.str(), _required);
+        this->beginRegistration();
+        // Create the option, which validates its values as `T`.
+        auto option = new detail::ValueOption(_opt_short, _opt_long, _description, detail::format_value(_value), _required,
+                                              &detail::validate_value<detail::value_type_t<T>>,
+                                              &detail::equal_values<detail::value_type_t<T>>);
         // Add the option.
         options.addOption(option);
+        schema_fingerprint = 0;
     }
 
     /// @brief Adds a toggle-based option to the parser.
@@ -82,130 +374,1648 @@ public:
                    const std::string &_description,
                    bool _toggled)
     {
+        this->beginRegistration();
         // Create the option.
         auto option = new detail::ToggleOption(_opt_short, _opt_long, _description, _toggled);
         // Add the option.
         options.addOption(option);
+        schema_fingerprint = 0;
+    }
+
+    /// @brief Adds an option whose value can be changed while the program runs.
+    /// @tparam T The type of the value, which must be arithmetic (e.g., `int` or `double`).
+    /// @param _opt_short The short version of the option (e.g., "-l").
+    /// @param _opt_long The long version of the option (e.g., "--log-level").
+    /// @param _description A description of the option, displayed in the help text.
+    /// @param _value The default value for the option.
+    /// @details The value is parsed from the command line as usual, then it can
+    /// be changed with `setLiveValue`, for instance by a `ControlServer`, and
+    /// read by other threads through the handle returned by `getLive`.
+    template <typename T>
+    void addLiveOption(const std::string &_opt_short,
+                       const std::string &_opt_long,
+                       const std::string &_description,
+                       T _value)
+    {
+        this->beginRegistration();
+        // Create the option.
+        auto option = new detail::LiveValueOption<T>(_opt_short, _opt_long, _description, _value);
+        // Add the option.
+        options.addOption(option);
+        schema_fingerprint = 0;
+    }
+
+    /// @brief Adds an option holding delimited tuples (e.g., "--endpoint 10.0.0.1:9000:3").
+    /// @tparam Ts The types of the elements of the tuples (e.g., `std::string, int, int`).
+    /// @param _opt_short The short version of the option (e.g., "-e").
+    /// @param _opt_long The long version of the option (e.g., "--endpoint").
+    /// @param _description A description of the option, displayed in the help text.
+    /// @param _delimiter The character separating the elements (e.g., ':').
+    /// @details The option can be repeated, each occurrence adds a tuple. The
+    /// tuples are split and converted by `value_traits` while parsing, and are
+    /// read back with `getTuples`.
+    template <typename... Ts>
+    void addTupleOption(const std::string &_opt_short,
+                        const std::string &_opt_long,
+                        const std::string &_description,
+                        char _delimiter)
+    {
+        static_assert(sizeof...(Ts) > 0, "A tuple option needs at least one element type.");
+        this->beginRegistration();
+        // Create the option.
+        auto option = new detail::TupleOption<Ts...>(_opt_short, _opt_long, _description, _delimiter);
+        // Add the option.
+        options.addOption(option);
+        schema_fingerprint = 0;
     }
 
     /// @brief Adds a separator for grouping options in the help message.
     /// @param _description The description of the separator (e.g., section title).
     void addSeparator(const std::string &_description)
     {
+        this->beginRegistration();
         auto separator = new detail::Separator(_description);
         options.addOption(separator);
+        schema_fingerprint = 0;
+    }
+
+    /// @brief Adds all the options of a fragment, in one operation.
+    /// @param fragment The fragment, which is copied and can be merged again.
+    /// @param prefix If not empty, the namespace the options are placed in
+    /// (e.g., "plugin" turns "--level" into "--plugin.level"), dropping their
+    /// short names.
+    /// @throws detail::OptionExistException if a name is already in use, in which case nothing is added.
+    void merge(const Fragment &fragment, const std::string &prefix = std::string())
+    {
+        this->beginRegistration();
+        options.merge(fragment.getOptions(), prefix);
+        schema_fingerprint = 0;
+    }
+
+    /// @brief Returns a namespace, registering options under a dotted prefix.
+    /// @param prefix The prefix, with or without leading dashes (e.g., "db.pool").
+    /// @return The namespace, which must not outlive the parser.
+    Namespace addNamespace(const std::string &prefix)
+    {
+        return Namespace(*this, prefix.substr(std::min(prefix.find_first_not_of('-'), prefix.size())));
+    }
+
+    /// @brief Adds the option used to select a profile.
+    /// @param _opt_short The short version of the option (e.g., "-p").
+    /// @param _opt_long The long version of the option (e.g., "--profile").
+    /// @param _description A description of the option, displayed in the help text.
+    /// @throws std::logic_error if a profile option has already been added.
+    void addProfileOption(const std::string &_opt_short,
+                          const std::string &_opt_long,
+                          const std::string &_description)
+    {
+        if (profile_slot != detail::OptionList::npos) {
+            throw std::logic_error("A profile option has already been added.");
+        }
+        this->beginRegistration();
+        // Create the option.
+        auto option = new detail::ProfileOption(_opt_short, _opt_long, _description);
+        // Add the option.
+        options.addOption(option);
+        profile_slot = options.size() - 1;
+        schema_fingerprint = 0;
+    }
+
+    /// @brief Adds a profile, a named bundle of values selected through the profile option.
+    /// @param _name The name used to select the profile (e.g., "low-latency").
+    /// @param _settings The values of the profile, as pairs of option name and value.
+    /// @throws std::logic_error if no profile option has been added.
+    /// @throws std::invalid_argument if the profile already exists, or if a
+    /// setting refers to an unknown option or holds a value it does not accept.
+    /// @details The settings are validated and converted here, once, except
+    /// the values of multi-options listed in a file, checked when the profile
+    /// is selected so that the file is not read before. When the profile is
+    /// selected, its values are applied before the ones given explicitly on
+    /// the command line, which take precedence.
+    void addProfile(const std::string &_name, const std::vector<std::pair<std::string, std::string>> &_settings)
+    {
+        if (profile_slot == detail::OptionList::npos) {
+            throw std::logic_error("A profile option must be added before the profiles.");
+        }
+        auto popt = static_cast<detail::ProfileOption *>(options.getOptionAt(profile_slot));
+        if (popt->findProfile(_name)) {
+            throw std::invalid_argument("Profile \"" + _name + "\" already exists.");
+        }
+        detail::ProfileOption::Profile profile{ _name, {} };
+        for (const auto &entry : _settings) {
+            std::size_t slot       = options.findSlot(entry.first);
+            detail::Option *option = (slot == detail::OptionList::npos) ? nullptr : options.getOptionAt(slot);
+            detail::ValueOption *vopt;
+            detail::MultiOption *mopt;
+            detail::LiveOption *lopt;
+            detail::ProfileOption::Setting setting{ slot, entry.second, false };
+            if (!option || (slot == profile_slot)) {
+                throw std::invalid_argument("Profile \"" + _name + "\" refers to an unknown option: " + entry.first);
+            } else if (dynamic_cast<detail::CompositeOption *>(option)) {
+                throw std::invalid_argument("Profile \"" + _name + "\" cannot set the tuple option " + entry.first);
+            } else if (dynamic_cast<detail::ToggleOption *>(option)) {
+                // Toggles accept the same values as everywhere else, through `value_traits<bool>`.
+                if (!value_traits<bool>::parse(entry.second, setting.toggled)) {
+                    throw std::invalid_argument("Profile \"" + _name + "\" sets toggle " + entry.first + " to \"" + entry.second + "\", expected true, false, 1 or 0.");
+                }
+                setting.value.clear();
+            } else if ((vopt = dynamic_cast<detail::ValueOption *>(option)) && vopt->validator && !vopt->validator(entry.second)) {
+                throw std::invalid_argument("Profile \"" + _name + "\" sets " + entry.first + " to \"" + entry.second + "\", which is not a valid value.");
+            } else if ((mopt = dynamic_cast<detail::MultiOption *>(option)) && !mopt->value_file && !mopt->isValueAllowed(entry.second)) {
+                throw std::invalid_argument("Profile \"" + _name + "\" sets " + entry.first + " to \"" + entry.second + "\", which is not in the list of allowed values: " + mopt->print_list());
+            } else if ((lopt = dynamic_cast<detail::LiveOption *>(option)) && !lopt->accepts(entry.second)) {
+                throw std::invalid_argument("Profile \"" + _name + "\" sets " + entry.first + " to \"" + entry.second + "\", which is not a valid " + lopt->type_name() + ".");
+            }
+            profile.settings.push_back(std::move(setting));
+        }
+        popt->profiles.push_back(std::move(profile));
+        options.updateLongestValue(_name.length(), popt->tier);
+        schema_fingerprint = 0;
+    }
+
+    /// @brief Derives the value of an option from the values of other options.
+    /// @tparam Function A callable accepting a `const Parser &` and returning the value.
+    /// @param opt The short or long name of the derived option, a value-based option.
+    /// @param dependencies The short or long names of the options the value is derived from.
+    /// @param derive Computes the value, reading the dependencies with `getOption`.
+    /// @throws std::invalid_argument if an option is unknown, or the derived one does not hold a value.
+    /// @throws std::logic_error if the derivation would make the option depend on itself.
+    /// @details The value is computed lazily, the first time the option is read
+    /// after parsing, and only if it was not set explicitly nor by a profile.
+    /// Derived dependencies are computed first, when `derive` reads them. Until
+    /// then, the option holds its default value. The first read of a derived
+    /// option modifies the parser, so it must not race with other reads.
+    template <typename Function>
+    void addDerivation(const std::string &opt, const std::vector<std::string> &dependencies, Function derive)
+    {
+        std::size_t slot = options.findSlot(opt);
+        if ((slot == detail::OptionList::npos) || !dynamic_cast<detail::ValueOption *>(options.getOptionAt(slot))) {
+            throw std::invalid_argument("Cannot derive unknown or non-value option: " + opt);
+        }
+        Derivation derivation;
+        derivation.compute = [derive](const Parser &parser) {
+            return detail::format_value(derive(parser));
+        };
+        derivation.pending = true;
+        for (const std::string &dependency : dependencies) {
+            std::size_t dependency_slot = options.findSlot(dependency);
+            if (dependency_slot == detail::OptionList::npos) {
+                throw std::invalid_argument("Derivation of " + opt + " refers to an unknown option: " + dependency);
+            }
+            if (this->dependsOn(dependency_slot, slot)) {
+                throw std::logic_error("Derivation of " + opt + " from " + dependency + " creates a cycle.");
+            }
+            derivation.dependencies.push_back(dependency_slot);
+        }
+        derivations[slot] = std::move(derivation);
+        schema_fingerprint = 0;
+    }
+
+    /// @brief Observes the changes of an option.
+    /// @param opt The short or long name of the option.
+    /// @param observer Called after each parse that changed the value of the option.
+    /// @throws std::invalid_argument if the option is unknown.
+    /// @details See `subscribeGroup` for when the observers are called.
+    void subscribe(const std::string &opt, observer_t observer)
+    {
+        std::size_t slot = options.findSlot(opt);
+        if (slot == detail::OptionList::npos) {
+            throw std::invalid_argument("Cannot observe unknown option: " + opt);
+        }
+        subscriptions.push_back(Subscription{ slot, false, std::move(observer) });
+    }
+
+    /// @brief Observes the changes of the options in a section of the help.
+    /// @param section The description of the separator opening the section.
+    /// @param observer Called after each parse that changed the value of an option in the section.
+    /// @throws std::invalid_argument if no separator has the given description.
+    /// @details The section extends to the next separator, options added to it
+    /// later are observed too. At the end of `parseOptions`, the values are
+    /// compared with the ones held before the call, and each observer is
+    /// called once with all the changed slots it observes. Observers run after
+    /// all the values have been assigned, so they can read any option.
+    void subscribeGroup(const std::string &section, observer_t observer)
+    {
+        std::size_t slot = options.findSection(section);
+        if (slot == detail::OptionList::npos) {
+            throw std::invalid_argument("Cannot observe unknown section: " + section);
+        }
+        subscriptions.push_back(Subscription{ slot, true, std::move(observer) });
     }
 
     /// @brief Retrieves the value of an option.
     /// @tparam T The expected type of the option value.
     /// @param opt The short or long name of the option.
-    /// @return The value of the option, or the default value of `T` if not found.
+    /// @return The value of the option, or the default value of `T` if not found or empty.
+    /// @throws std::invalid_argument if the value cannot be converted to `T`.
+    /// @details Derived options are computed here, on first read.
     template <typename T>
     inline T getOption(const std::string &opt) const
     {
+        if (!derivations.empty()) {
+            this->evaluate(options.findSlot(opt));
+        }
         return options.getOption<T>(opt);
     }
 
+    /// @brief Retrieves the value of an option without copying it.
+    /// @param opt The short or long name of the option.
+    /// @return A view of the value, or an empty view if not found.
+    /// @throws std::invalid_argument if the option does not store its value as
+    /// text (composite and live options, see `getOption<std::string>`).
+    /// @details The view remains valid until the options are parsed or reset again.
+    inline std::string_view getOptionView(const std::string &opt) const
+    {
+        if (!derivations.empty()) {
+            this->evaluate(options.findSlot(opt));
+        }
+        return options.getOptionView(opt);
+    }
+
+    /// @brief Returns a handle reading an option without looking up its name.
+    /// @tparam T The type of the value, `std::string` options are read as views.
+    /// @param opt The short or long name of the option.
+    /// @return The handle.
+    /// @throws std::invalid_argument if the option is unknown, or a string
+    /// handle is requested for an option that does not store its value as text.
+    template <typename T>
+    Handle<T> getHandle(const std::string &opt) const
+    {
+        std::size_t slot = options.findSlot(opt);
+        if (slot == detail::OptionList::npos) {
+            throw std::invalid_argument("Cannot find option: " + opt);
+        }
+        if constexpr (std::is_same_v<T, std::string>) {
+            if (!detail::OptionList::hasTextValue(options.getOptionAt(slot))) {
+                throw std::invalid_argument("Option " + opt + " does not store its value as text");
+            }
+        }
+        return Handle<T>(this, slot);
+    }
+
+    /// @brief Retrieves the tuples collected by a tuple option.
+    /// @tparam Ts The types of the elements, the same given to `addTupleOption`.
+    /// @param opt The short or long name of the option.
+    /// @return The tuples, in the order they appear on the command line.
+    /// @throws std::invalid_argument if the option is unknown, or holds other element types.
+    template <typename... Ts>
+    const std::vector<std::tuple<Ts...>> &getTuples(const std::string &opt) const
+    {
+        auto topt = dynamic_cast<const detail::TupleOption<Ts...> *>(options.findOption(opt));
+        if (!topt) {
+            throw std::invalid_argument("Cannot find tuple option with the given element types: " + opt);
+        }
+#ifdef CMDLP_ACCESS_STATS
+        topt->stats->countRead();
+#endif
+        return topt->values;
+    }
+
+    /// @brief Returns a handle reading a live option from any thread.
+    /// @tparam T The type of the value, the same given to `addLiveOption`.
+    /// @param opt The short or long name of the option.
+    /// @return The handle.
+    /// @throws std::invalid_argument if the option is unknown, or holds another type.
+    template <typename T>
+    Live<T> getLive(const std::string &opt) const
+    {
+        auto lopt = dynamic_cast<const detail::LiveValueOption<T> *>(options.findOption(opt));
+        if (!lopt) {
+            throw std::invalid_argument("Cannot find live option with the given type: " + opt);
+        }
+        return Live<T>(&lopt->value);
+    }
+
+    /// @brief Lists the live options.
+    /// @return The long name and the type name of each live option, in slot order.
+    std::vector<std::pair<std::string, std::string>> getLiveOptions() const
+    {
+        std::vector<std::pair<std::string, std::string>> result;
+        for (detail::OptionList::const_iterator_t it = options.begin(); it != options.end(); ++it) {
+            if (auto lopt = dynamic_cast<const detail::LiveOption *>(*it)) {
+                result.emplace_back(lopt->opt_long, lopt->type_name());
+            }
+        }
+        return result;
+    }
+
+    /// @brief Formats the current value of a live option.
+    /// @param opt The short or long name of the option.
+    /// @return The value.
+    /// @throws std::invalid_argument if the option is unknown or not live.
+    std::string getLiveValue(const std::string &opt) const
+    {
+        auto lopt = dynamic_cast<const detail::LiveOption *>(options.findOption(opt));
+        if (!lopt) {
+            throw std::invalid_argument("Cannot find live option: " + opt);
+        }
+        return lopt->load_text();
+    }
+
+    /// @brief Changes the value of a live option.
+    /// @param opt The short or long name of the option.
+    /// @param text The new value, converted to the type of the option.
+    /// @throws std::invalid_argument if the option is unknown, not live, or the value is not valid.
+    /// @details The value is stored atomically, so it can be called while other
+    /// threads read the option, but not while the options are being parsed.
+    /// The value survives a later `parseOptions`, unless the arguments, a
+    /// source or the profile assign the option again; its origin is
+    /// `ValueOrigin::runtime` until then. If the option is readable from
+    /// signal handlers, its value is published again.
+    void setLiveValue(const std::string &opt, std::string_view text)
+    {
+        std::size_t slot = options.findSlot(opt);
+        auto lopt        = (slot == detail::OptionList::npos) ? nullptr : dynamic_cast<detail::LiveOption *>(options.getOptionAt(slot));
+        if (!lopt) {
+            throw std::invalid_argument("Cannot find live option: " + opt);
+        }
+        if (!lopt->store(text)) {
+            throw std::invalid_argument("Value \"" + std::string(text) + "\" is not a valid " + lopt->type_name() + " for option " + lopt->opt_long);
+        }
+        lopt->changed.store(true, std::memory_order_relaxed);
+        if (signal_table.contains(slot)) {
+            this->publishSignalSafe();
+        }
+    }
+
+    /// @brief Completes a partial value of a multi-option, e.g. for shell completion.
+    /// @param opt The short or long name of the option.
+    /// @param prefix The partial value.
+    /// @return The allowed values starting with the prefix, sorted.
+    /// @throws std::invalid_argument if the option is unknown or not a multi-option.
+    /// @throws std::runtime_error if the file listing the values cannot be read.
+    std::vector<std::string> completeValue(const std::string &opt, std::string_view prefix) const
+    {
+        auto mopt = dynamic_cast<const detail::MultiOption *>(options.findOption(opt));
+        if (!mopt) {
+            throw std::invalid_argument("Cannot find multi-option: " + opt);
+        }
+        return mopt->complete(prefix);
+    }
+
+    /// @brief Makes an option readable from signal handlers, see `readSignalSafe`.
+    /// @param opt The short or long name of the option.
+    /// @return The handle used to read the option.
+    /// @throws std::invalid_argument if the option is unknown.
+    /// @details The value is converted and copied aside now, and again at the
+    /// end of each `parseOptions`, `setLiveValue` on the option and
+    /// `resetNamespace` holding it. Call it before installing the handlers.
+    SignalSafeHandle addSignalSafe(const std::string &opt)
+    {
+        std::size_t slot = options.findSlot(opt);
+        if ((slot == detail::OptionList::npos) || dynamic_cast<detail::Separator *>(options.getOptionAt(slot))) {
+            throw std::invalid_argument("Cannot find option: " + opt);
+        }
+        SignalSafeHandle handle{ signal_table.add(slot) };
+        this->publishSignalSafe();
+        return handle;
+    }
+
+    /// @brief Copies the text of an option into a buffer, as `snprintf` does.
+    /// @param handle The handle returned by `addSignalSafe`.
+    /// @param buffer The buffer, always null-terminated when `size` is not zero.
+    /// @param size The size of the buffer.
+    /// @return The length of the value, which was truncated if not smaller than `size`.
+    /// @details This overload and the others are async-signal-safe: they
+    /// perform no allocation, take no lock and throw no exception, so they
+    /// can be called from signal handlers and crash paths, even while the
+    /// options are being parsed again.
+    std::size_t readSignalSafe(SignalSafeHandle handle, char *buffer, std::size_t size) const noexcept
+    {
+        return signal_table.readText(handle.index, buffer, size);
+    }
+
+    /// @brief Reads an option as an integer, async-signal-safely.
+    /// @param handle The handle returned by `addSignalSafe`.
+    /// @param value Set to the value, if it is an integer.
+    /// @return False if the value is not an integer.
+    bool readSignalSafe(SignalSafeHandle handle, long long &value) const noexcept
+    {
+        return signal_table.readInteger(handle.index, value);
+    }
+
+    /// @brief Reads an option as a floating-point number, async-signal-safely.
+    /// @param handle The handle returned by `addSignalSafe`.
+    /// @param value Set to the value, if it is a number.
+    /// @return False if the value is not a number.
+    bool readSignalSafe(SignalSafeHandle handle, double &value) const noexcept
+    {
+        return signal_table.readReal(handle.index, value);
+    }
+
+    /// @brief Reads a toggle, async-signal-safely.
+    /// @param handle The handle returned by `addSignalSafe`.
+    /// @param value Set to the state of the toggle.
+    /// @return False if the handle is not valid.
+    bool readSignalSafe(SignalSafeHandle handle, bool &value) const noexcept
+    {
+        return signal_table.readToggle(handle.index, value);
+    }
+
+    /// @brief Declares a configuration source, read before the command line.
+    /// @param source The source (e.g., `std::make_shared<cmdlp::FileSource>("/etc/app.conf")`).
+    /// @details Sources declared later take precedence over the ones declared
+    /// earlier, and the command line over all of them. Values from the sources
+    /// satisfy required options, and are overridden by the selected profile.
+    void addSource(std::shared_ptr<const ConfigSource> source)
+    {
+        sources.push_back(std::move(source));
+        sources_loaded = false;
+    }
+
+    /// @brief Reads all the configuration sources, concurrently.
+    /// @param max_threads The maximum number of threads, the calling one included.
+    /// @throws std::invalid_argument if a source is malformed or names an unknown option.
+    /// @throws std::runtime_error if a source cannot be read.
+    /// @details Each source is read and tokenized on its own thread, then the
+    /// settings are merged in declaration order, so the result does not depend
+    /// on which source finishes first. When several sources fail, the error of
+    /// the first one declared is reported. It is called by `parseOptions` if
+    /// needed; call it again to reload the sources. On error, the values loaded
+    /// before are kept.
+    void loadSources(std::size_t max_threads = 4)
+    {
+        this->endRegistration();
+        detail::TraceScope scope(tracer, "sources");
+        std::vector<std::vector<ConfigSource::Setting>> loaded(sources.size());
+        std::vector<std::exception_ptr> errors(sources.size());
+        std::atomic<std::size_t> next(0);
+        auto worker = [&]() {
+            for (std::size_t index; (index = next.fetch_add(1, std::memory_order_relaxed)) < sources.size();) {
+                try {
+                    sources[index]->load(options, loaded[index]);
+                } catch (...) {
+                    errors[index] = std::current_exception();
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        for (std::size_t i = 1; i < std::min(max_threads, sources.size()); ++i) {
+            try {
+                workers.emplace_back(worker);
+            } catch (const std::system_error &) {
+                // Go on with the threads already running.
+                break;
+            }
+        }
+        worker();
+        for (std::thread &thread : workers) {
+            thread.join();
+        }
+        for (const std::exception_ptr &error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+        // Merge by precedence, a later value replaces an earlier one, except for
+        // tuple options, which collect all of them.
+        // The merge is built on the side, so that an error keeps the values loaded before.
+        std::vector<std::size_t> position(options.size(), detail::OptionList::npos);
+        std::vector<SourceValue> merged;
+        for (std::size_t index = 0; index < sources.size(); ++index) {
+            for (ConfigSource::Setting &setting : loaded[index]) {
+                std::size_t slot = options.findSlot(setting.name);
+                if ((slot == detail::OptionList::npos) || dynamic_cast<detail::Separator *>(options.getOptionAt(slot))) {
+                    throw std::invalid_argument(sources[index]->name() + " sets an unknown option: " + setting.name);
+                }
+                if ((position[slot] == detail::OptionList::npos) || dynamic_cast<detail::CompositeOption *>(options.getOptionAt(slot))) {
+                    position[slot] = merged.size();
+                    merged.push_back(SourceValue{ slot, std::move(setting.value), index });
+                } else {
+                    merged[position[slot]].value  = std::move(setting.value);
+                    merged[position[slot]].source = index;
+                }
+            }
+        }
+        source_values.swap(merged);
+        sources_loaded     = true;
+        schema_fingerprint = 0;
+        if (tracer) {
+            tracer->counter("source values", source_values.size());
+        }
+    }
+
+    /// @brief Walks the command-line arguments, reporting each option and positional argument found.
+    /// @tparam Visitor A callable accepting a `const ParseEvent &`.
+    /// @param visitor Called once per event, in the order the arguments appear.
+    /// @details Option values are not converted nor stored, and walking the
+    /// arguments performs no allocation. The views held by the events remain
+    /// valid until the arguments are replaced.
+    template <typename Visitor>
+    void parseEvents(Visitor &&visitor) const
+    {
+        this->endRegistration();
+        detail::TraceScope scope(tracer, "events");
+        detail::EventCursor cursor(tokenizer, options);
+        ParseEvent event;
+        while (cursor.next(event)) {
+            visitor(static_cast<const ParseEvent &>(event));
+        }
+    }
+
+    /// @brief Reads arguments lazily from a stream, such as a response file or a pipe.
+    /// @param input The stream the arguments are read from.
+    /// @return A cursor producing one event per call to `next`, reading only the tokens it needs.
+    /// @details The first event is available as soon as its tokens have been
+    /// read, and memory does not grow with the number of arguments. Both the
+    /// stream and the parser must outlive the cursor.
+    EventCursor streamEvents(std::istream &input) const
+    {
+        this->endRegistration();
+        return EventCursor(input, options);
+    }
+
     /// @brief Parses the registered options from the command-line arguments.
     /// @details Reads the command-line arguments and assigns values to the corresponding options.
     /// If a required option is missing, the program will print an error and exit.
+    /// When an option appears more than once, the first occurrence of its short
+    /// version wins over the first occurrence of its long version. When parsing
+    /// again, options missing from the new arguments get back their default value.
+    /// All the values are checked before any option is modified, so a failed
+    /// parse leaves the options, their origins and the observers untouched.
+    /// @throws std::invalid_argument if a value is not valid for the type of its
+    /// option, according to `value_traits`, or is not allowed by a multi-option.
     void parseOptions()
     {
-        std::string value;
-        for (detail::OptionList::const_iterator_t it = options.begin(); it != options.end(); ++it) {
+        this->endRegistration();
+        detail::TraceScope scope(tracer, "parse");
+        if (!sources.empty() && !sources_loaded) {
+            this->loadSources();
+        }
+        // Record the first occurrence of each name, walking the arguments once.
+        // Composite options collect all their occurrences instead.
+        std::vector<Occurrence> found(options.size());
+        std::vector<std::pair<detail::CompositeOption *, std::string_view>> tuples;
+        detail::EventCursor cursor(tokenizer, options);
+        detail::ParseEvent event;
+        detail::CompositeOption *copt;
+        while (cursor.next(event)) {
+            if (event.isPositional()) {
+                continue;
+            }
+            found[event.slot].record(event, event.name == event.option->opt_short);
+            if (event.has_value && (copt = dynamic_cast<detail::CompositeOption *>(options.getOptionAt(event.slot)))) {
+                if (!copt->accepts(event.value)) {
+                    throw std::invalid_argument("Value \"" + std::string(event.value) + "\" is not valid for option " + copt->opt_long);
+                }
+                tuples.emplace_back(copt, event.value);
+            }
+        }
+        const std::string profile = this->checkValues(found);
+        // Remember the values of the observed options, to tell the observers what changed.
+        std::vector<std::size_t> observed;
+        std::vector<std::string> previous;
+        if (!subscriptions.empty()) {
+            observed = this->getObservedSlots();
+            previous = this->saveValues(observed);
+        }
+        // Nothing can fail from here on. Start again from the default values,
+        // keeping the live values changed at runtime.
+        for (std::size_t slot = 0; slot < options.size(); ++slot) {
+            detail::Option *option = options.getOptionAt(slot);
+            auto lopt              = dynamic_cast<detail::LiveOption *>(option);
+            if (!lopt || !lopt->changed.load(std::memory_order_relaxed)) {
+                option->reset_value();
+            }
+        }
+        origins.assign(options.size(), ValueOrigin::default_value);
+        for (const auto &tuple : tuples) {
+            tuple.first->append(tuple.second);
+        }
+        // Apply the configuration sources, then the selected profile, the
+        // explicit values assigned below take precedence.
+        std::size_t matched = 0;
+        std::vector<bool> preset(options.size(), false);
+        this->applySources(found, preset);
+        if (!profile.empty()) {
+            this->applyProfile(profile, preset);
+            this->countHit(options.getOptionAt(profile_slot), matched);
+        }
+        // Assign the values, in the order the options were registered.
+        for (std::size_t slot = 0; slot < options.size(); ++slot) {
+            detail::Option *option = options.getOptionAt(slot);
+            std::string_view value = found[slot].getValue();
             detail::ValueOption *vopt;
             detail::ToggleOption *topt;
             detail::MultiOption *mopt;
+            detail::LiveOption *lopt;
 
             // Check if it is a value-holding option.
-            if ((vopt = dynamic_cast<detail::ValueOption *>(*it))) {
-                // Try to search for the option.
-                value = tokenizer.getOption(vopt->opt_short);
+            if ((vopt = dynamic_cast<detail::ValueOption *>(option))) {
+                // Derived options are computed when read, unless set explicitly.
+                if (!derivations.empty()) {
+                    auto derivation = derivations.find(slot);
+                    if (derivation != derivations.end()) {
+                        derivation->second.pending = value.empty() && !preset[slot];
+                    }
+                }
+                // If the option is required but missing, print an error and exit.
                 if (value.empty()) {
-                    // Try to search for the option again using the long version.
-                    value = tokenizer.getOption(vopt->opt_long);
-                    // If the option is required but missing, print an error and exit.
-                    if (value.empty()) {
-                        if (vopt->required) {
-                            std::cerr << "Cannot find required option: " << vopt->opt_long << "[" << vopt->opt_short << "]\n";
-                            std::cerr << this->getHelp() << "\n";
-                            std::exit(1);
-                        } else {
-                            continue;
-                        }
+                    if (vopt->required && !preset[slot]) {
+                        std::cerr << "Cannot find required option: " << vopt->opt_long << "[" << vopt->opt_short << "]\n";
+                        std::cerr << this->getHelp() << "\n";
+                        std::exit(1);
                     }
+                    continue;
                 }
-                vopt->value = value;
-                options.updateLongestValue(vopt->value.length());
+                vopt->value.assign(value.data(), value.size());
+                options.updateLongestValue(vopt->value.length(), vopt->tier);
+                this->countHit(option, matched);
             }
             // Check if it is a multi-option.
-            if ((mopt = dynamic_cast<detail::MultiOption *>(*it))) {
-                // Try to search for the option.
-                value = tokenizer.getOption(mopt->opt_short);
+            else if ((mopt = dynamic_cast<detail::MultiOption *>(option))) {
                 if (value.empty()) {
-                    // Try to search for the option again using the long version.
-                    value = tokenizer.getOption(mopt->opt_long);
-                    // If the option is required but missing, print an error and exit.
-                    if (value.empty()) {
-                        continue;
-                    }
+                    continue;
                 }
-                mopt->setValue(value);
-                options.updateLongestValue(mopt->selected_value.length());
+                mopt->selected_value.assign(value.data(), value.size());
+                options.updateLongestValue(mopt->selected_value.length(), mopt->tier);
+                this->countHit(option, matched);
             }
             // Check if it is a toggle option.
-            else if ((topt = dynamic_cast<detail::ToggleOption *>(*it))) {
-                if (tokenizer.hasOption(topt->opt_short) || tokenizer.hasOption(topt->opt_long)) {
+            else if ((topt = dynamic_cast<detail::ToggleOption *>(option))) {
+                if (found[slot].isFound()) {
                     topt->toggled = true;
+                    this->countHit(option, matched);
+                }
+            }
+            // Check if it is a composite option, whose values are already collected.
+            else if ((copt = dynamic_cast<detail::CompositeOption *>(option))) {
+                if (copt->count() > 0) {
+                    options.updateLongestValue(copt->format_values().length(), copt->tier);
+                    this->countHit(option, matched);
+                }
+            }
+            // Check if it is a live option.
+            else if ((lopt = dynamic_cast<detail::LiveOption *>(option))) {
+                if (value.empty()) {
+                    continue;
                 }
+                lopt->store(value);
+                options.updateLongestValue(value.length(), lopt->tier);
+                this->countHit(option, matched);
+            }
+        }
+        // The values found on the command line take precedence over any other.
+        for (std::size_t slot = 0; slot < options.size(); ++slot) {
+            if (found[slot].isFound() && (!options.getOptionAt(slot)->takes_value() || !found[slot].getValue().empty())) {
+                origins[slot] = ValueOrigin::command_line;
+            }
+            // A live value assigned again while parsing is no longer the one changed at runtime.
+            auto lopt = dynamic_cast<detail::LiveOption *>(options.getOptionAt(slot));
+            if (lopt && (origins[slot] != ValueOrigin::default_value)) {
+                lopt->changed.store(false, std::memory_order_relaxed);
             }
         }
         option_parsed = true;
+        if (!signal_table.empty()) {
+            this->publishSignalSafe();
+        }
+        if (tracer) {
+            tracer->counter("matched", matched);
+        }
+        if (!subscriptions.empty()) {
+            this->notifyObservers(observed, previous);
+        }
+    }
+
+    /// @brief Returns a fingerprint of what a parse depends on, besides the arguments.
+    /// @return A 64-bit hash, which changes whenever an option or a profile is
+    /// added, or the sources are loaded again.
+    /// @details Covers the names and the default values of the options, the
+    /// derivations, the profiles and the values loaded from the sources, but not
+    /// the current values, which a parse replaces. The fingerprint is computed on
+    /// first use and cached until the schema changes.
+    uint64_t fingerprint() const
+    {
+        if (schema_fingerprint == 0) {
+            uint64_t hash = detail::fnv1a_basis;
+            for (detail::OptionList::const_iterator_t it = options.begin(); it != options.end(); ++it) {
+                hash = detail::fnv1a((*it)->opt_short, hash);
+                hash = detail::fnv1a((*it)->opt_long, hash);
+                hash = detail::fnv1a(Parser::getDefault(*it), hash);
+                auto derivation = derivations.find(static_cast<std::size_t>(it - options.begin()));
+                if (derivation != derivations.end()) {
+                    const std::vector<std::size_t> &dependencies = derivation->second.dependencies;
+                    hash = detail::fnv1a(dependencies.data(), dependencies.size() * sizeof(std::size_t), hash);
+                }
+                if (auto popt = dynamic_cast<const detail::ProfileOption *>(*it)) {
+                    for (const detail::ProfileOption::Profile &profile : popt->profiles) {
+                        hash = detail::fnv1a(profile.name, hash);
+                        for (const detail::ProfileOption::Setting &setting : profile.settings) {
+                            hash = detail::fnv1a(&setting.slot, sizeof(setting.slot), hash);
+                            hash = detail::fnv1a(setting.toggled ? setting.value + "1" : setting.value, hash);
+                        }
+                    }
+                }
+            }
+            for (const SourceValue &entry : source_values) {
+                hash = detail::fnv1a(&entry.slot, sizeof(entry.slot), hash);
+                hash = detail::fnv1a(entry.value, hash);
+            }
+            schema_fingerprint = (hash == 0) ? 1 : hash;
+        }
+        return schema_fingerprint;
+    }
+
+    /// @brief Reports the memory used by the registered options and the parsed arguments.
+    /// @return The bytes used, broken down into schema, names, descriptions, values and indices.
+    detail::MemoryUsage memoryUsage() const
+    {
+        detail::MemoryUsage usage;
+        usage.schema += sizeof(Parser) - sizeof(detail::Tokenizer) - sizeof(detail::OptionList);
+        tokenizer.getMemoryUsage(usage);
+        options.getMemoryUsage(usage);
+        help_index.getMemoryUsage(usage);
+        signal_table.getMemoryUsage(usage);
+        usage.values += origins.capacity() * sizeof(ValueOrigin);
+        return usage;
+    }
+
+#ifdef CMDLP_ACCESS_STATS
+    /// @brief Writes how many times each option was read and found on the command line.
+    /// @param os The stream the report is written to.
+    /// @details Options are sorted by number of reads, the ones that were never
+    /// read are marked as unused, even if they were given on the command line.
+    /// The reads through the copies of the parser are included.
+    void writeAccessReport(std::ostream &os) const
+    {
+        std::vector<detail::access_entry_t> entries;
+        for (detail::OptionList::const_iterator_t it = options.begin(); it != options.end(); ++it) {
+            if (!dynamic_cast<const detail::Separator *>(*it)) {
+                entries.emplace_back((*it)->opt_long, (*it)->stats);
+            }
+        }
+        detail::write_access_report(os, std::move(entries));
+    }
+#endif
+
+    /// @brief Generates a help string for a single section.
+    /// @param section The description of the separator opening the section.
+    /// @param tier The most detailed tier shown.
+    /// @return The help text of the section, empty if no separator has the
+    /// given description or if the separator is not shown in the tier.
+    /// @details Only the options of the section are visited, e.g., to implement `--help <section>`.
+    std::string getHelp(const std::string &section, HelpTier tier = HelpTier::basic) const
+    {
+        this->endRegistration();
+        detail::TraceScope scope(tracer, "help");
+        std::size_t begin = options.findSection(section);
+        if ((begin == detail::OptionList::npos) || (options.getOptionAt(begin)->tier > tier)) {
+            return "";
+        }
+        std::stringstream ss;
+        ss << "\n"
+           << section << "\n";
+        for (std::size_t slot = begin + 1, end = options.getSectionEnd(begin); slot < end; ++slot) {
+            this->evaluate(slot);
+            this->writeHelp(ss, options.getOptionAt(slot), tier);
+        }
+        return ss.str();
+    }
+
+    /// @brief Generates a help string for the options matching a query, e.g., to implement `--help-search <word>`.
+    /// @param query One or more words, all of which must appear in the names or in the description of an option.
+    /// @param tier The most detailed tier shown.
+    /// @return The help text of the matching options, in registration order.
+    /// @details Words are compared without regard to case. The inverted index
+    /// of the words is built on first use, and again after new options are
+    /// added; building it modifies the parser, so it must not race with other calls.
+    std::string searchHelp(const std::string &query, HelpTier tier = HelpTier::basic) const
+    {
+        this->endRegistration();
+        detail::TraceScope scope(tracer, "help");
+        if (help_index.empty()) {
+            help_index.build(options);
+        }
+        std::stringstream ss;
+        for (std::size_t slot : help_index.search(query)) {
+            this->evaluate(slot);
+            this->writeHelp(ss, options.getOptionAt(slot), tier);
+        }
+        return ss.str();
+    }
+
+    /// @brief Generates a help string for the options below a namespace.
+    /// @param prefix The namespace (e.g., "db.pool").
+    /// @param tier The most detailed tier shown.
+    /// @return The help text of the options in the namespace, in registration order.
+    std::string getNamespaceHelp(const std::string &prefix, HelpTier tier = HelpTier::basic) const
+    {
+        this->endRegistration();
+        detail::TraceScope scope(tracer, "help");
+        std::stringstream ss;
+        for (std::size_t slot : options.findNamespace(prefix)) {
+            this->evaluate(slot);
+            this->writeHelp(ss, options.getOptionAt(slot), tier);
+        }
+        return ss.str();
+    }
+
+    /// @brief Exports the current values of the options below a namespace.
+    /// @param prefix The namespace (e.g., "db.pool").
+    /// @return The pairs of long name and value, in registration order. They
+    /// can be used as the settings of a profile.
+    std::vector<std::pair<std::string, std::string>> exportNamespace(const std::string &prefix) const
+    {
+        std::vector<std::pair<std::string, std::string>> values;
+        for (std::size_t slot : options.findNamespace(prefix)) {
+            this->evaluate(slot);
+            const detail::Option *option = options.getOptionAt(slot);
+            values.emplace_back(option->opt_long, detail::OptionList::getValue(option));
+        }
+        return values;
+    }
+
+    /// @brief Restores the default value of the options below a namespace.
+    /// @param prefix The namespace (e.g., "db.pool").
+    /// @details Derived options in the namespace are computed again on next read.
+    /// The reset options report `ValueOrigin::default_value`, and the values
+    /// readable from signal handlers are published again.
+    void resetNamespace(const std::string &prefix)
+    {
+        bool signal_safe = false;
+        for (std::size_t slot : options.findNamespace(prefix)) {
+            options.getOptionAt(slot)->reset_value();
+            if (slot < origins.size()) {
+                origins[slot] = ValueOrigin::default_value;
+            }
+            auto derivation = derivations.find(slot);
+            if (derivation != derivations.end()) {
+                derivation->second.pending = true;
+            }
+            signal_safe = signal_safe || signal_table.contains(slot);
+        }
+        if (signal_safe) {
+            this->publishSignalSafe();
+        }
+    }
+
+    /// @brief Moves an option, or a whole section, to another tier of the help.
+    /// @param name The short or long name of an option, or the description of a separator.
+    /// @param tier The new tier.
+    /// @throws std::invalid_argument if no option nor separator has the given name.
+    /// @details Moving a separator also moves all the options of its section,
+    /// including the ones added to it afterwards.
+    /// The column widths of each tier are computed here, so that rendering a
+    /// tier does not depend on the options it does not show.
+    void setTier(const std::string &name, HelpTier tier)
+    {
+        std::size_t slot = options.findSlot(name);
+        if (slot != detail::OptionList::npos) {
+            options.setTier(slot, slot + 1, tier);
+        } else if ((slot = options.findSection(name)) != detail::OptionList::npos) {
+            options.setTier(slot, options.getSectionEnd(slot), tier);
+        } else {
+            throw std::invalid_argument("Cannot find option or section: " + name);
+        }
     }
 
-    /// @brief Generates a help string for all registered options.
-    /// @return A string containing the help text for all options.
+    /// @brief Tells where the current value of an option comes from.
+    /// @param opt The short or long name of the option.
+    /// @return The origin of the value, `ValueOrigin::default_value` before parsing.
+    /// @throws std::invalid_argument if the option is unknown.
+    ValueOrigin getOrigin(const std::string &opt) const
+    {
+        std::size_t slot = options.findSlot(opt);
+        if (slot == detail::OptionList::npos) {
+            throw std::invalid_argument("Cannot find option: " + opt);
+        }
+        this->evaluate(slot);
+        return this->originAt(slot);
+    }
+
+    /// @brief Writes the effective configuration, one entry per option.
+    /// @param os The output stream.
+    /// @param only_non_default Whether the options still holding their default value are skipped.
+    /// @param format The format of the entries.
+    /// @details Names are long names without their leading dashes (short names
+    /// for options without one). Values are streamed from the storage of the
+    /// options, without going through `getOption`, and the names are padded
+    /// to the longest printed one. The output can be read back by a
+    /// `FileSource` or a `JsonSource`, respectively.
+    void writeEffectiveConfig(std::ostream &os, bool only_non_default = false, ConfigFormat format = ConfigFormat::lines) const
+    {
+        this->endRegistration();
+        detail::TraceScope scope(tracer, "effective config");
+        for (const auto &derivation : derivations) {
+            this->evaluate(derivation.first);
+        }
+        std::vector<std::pair<const detail::Option *, std::string_view>> entries;
+        std::size_t width = 0;
+        for (std::size_t slot = 0; slot < options.size(); ++slot) {
+            const detail::Option *option = options.getOptionAt(slot);
+            if (dynamic_cast<const detail::Separator *>(option)) {
+                continue;
+            }
+            if (only_non_default && (this->originAt(slot) == ValueOrigin::default_value)) {
+                continue;
+            }
+            std::string_view name(option->opt_long.empty() ? option->opt_short : option->opt_long);
+            name.remove_prefix(std::min(name.find_first_not_of('-'), name.size()));
+            entries.emplace_back(option, name);
+            width = std::max(width, name.size());
+        }
+        bool first = true;
+        if (format == ConfigFormat::json) {
+            os << "{";
+        }
+        for (const auto &entry : entries) {
+            if (format == ConfigFormat::json) {
+                os << (first ? "\n  " : ",\n  ");
+                Parser::writeJsonString(os, entry.second);
+                os << ": ";
+                this->writeJsonValue(os, entry.first);
+            } else {
+                os << std::setw(static_cast<int>(width)) << std::left << entry.second << " = ";
+                this->writeValue(os, entry.first);
+                os << "\n";
+            }
+            first = false;
+        }
+        if (format == ConfigFormat::json) {
+            os << (first ? "}\n" : "\n}\n");
+        }
+    }
+
+    /// @brief Generates a help string for the registered options.
+    /// @param tier The most detailed tier shown, the default help only shows the basic options.
+    /// @return A string containing the help text for the options of the tier.
     /// @details Lists all options with their short and long names, default values, and descriptions.
-    std::string getHelp() const
+    /// The columns are as wide as required by the options of the tier.
+    std::string getHelp(HelpTier tier = HelpTier::basic) const
     {
+        this->endRegistration();
+        detail::TraceScope scope(tracer, "help");
+        for (const auto &derivation : derivations) {
+            this->evaluate(derivation.first);
+        }
         std::stringstream ss;
         for (detail::OptionList::const_iterator_t it = options.begin(); it != options.end(); ++it) {
             const detail::Separator *sep = nullptr;
             if ((sep = dynamic_cast<const detail::Separator *>(*it))) {
-                ss << "\n"
-                   << sep->description << "\n";
+                if (sep->tier <= tier) {
+                    ss << "\n"
+                       << sep->description << "\n";
+                }
             } else {
-                const detail::ValueOption *vopt  = nullptr;
-                const detail::ToggleOption *topt = nullptr;
-                const detail::MultiOption *mopt  = nullptr;
-                ss << "[" << std::setw(options.getLongestShortOption<int>()) << std::left << (*it)->opt_short << "] ";
-                ss << std::setw(options.getLongestLongOption<int>()) << std::left << (*it)->opt_long;
-                ss << " (" << std::setw(options.getLongestValue<int>()) << std::right;
-                if ((vopt = dynamic_cast<const detail::ValueOption *>(*it))) {
-                    ss << vopt->value;
-                } else if ((topt = dynamic_cast<const detail::ToggleOption *>(*it))) {
-                    ss << (topt->toggled ? "true" : "false");
-                } else if ((mopt = dynamic_cast<const detail::MultiOption *>(*it))) {
-                    ss << mopt->selected_value;
-                }
-                ss << ") : ";
-                ss << (*it)->description;
-                if (mopt) {
-                    ss << " " << mopt->print_list();
-                }
-                ss << "\n";
+                this->writeHelp(ss, *it, tier);
             }
         }
         return ss.str();
     }
 
 private:
+    template <typename T>
+    friend class Handle;
+    friend class ParseCache;
+
+    /// @brief Selects the constructor of the copies made by `ParseCache`.
+    struct Detached {};
+
+    /// @brief Copies a parser, leaving out its observers and its tracing sink.
+    /// @param other The `Parser` to copy, whose sources must be already loaded.
+    /// @details The copy reuses the values loaded from the sources, and never
+    /// loads them again. Live values changed at runtime are not copied, since
+    /// they are not part of the fingerprint.
+    Parser(const Parser &other, Detached)
+        : tracer(nullptr),
+          registering(false),
+          tokenizer(other.tokenizer),
+          options(other.options),
+          option_parsed(other.option_parsed),
+          schema_fingerprint(other.schema_fingerprint),
+          profile_slot(other.profile_slot),
+          derivations(other.derivations),
+          subscriptions(),
+          help_index(),
+          signal_table(other.signal_table),
+          sources(other.sources),
+          source_values(other.source_values),
+          sources_loaded(true),
+          origins(other.origins)
+    {
+        for (std::size_t slot = 0; slot < options.size(); ++slot) {
+            auto lopt = dynamic_cast<detail::LiveOption *>(options.getOptionAt(slot));
+            if (lopt && lopt->changed.load(std::memory_order_relaxed)) {
+                lopt->reset_value();
+            }
+        }
+    }
+
+    /// @brief Returns the text of the value an option gets back when it is reset.
+    /// @param option The option.
+    /// @return The default value, empty for the options without one.
+    static std::string getDefault(const detail::Option *option)
+    {
+        const detail::ValueOption *vopt;
+        const detail::ToggleOption *topt;
+        const detail::MultiOption *mopt;
+        const detail::LiveOption *lopt;
+        if ((vopt = dynamic_cast<const detail::ValueOption *>(option))) {
+            return vopt->default_value;
+        }
+        if ((topt = dynamic_cast<const detail::ToggleOption *>(option))) {
+            return topt->default_toggled ? "1" : "0";
+        }
+        if ((mopt = dynamic_cast<const detail::MultiOption *>(option))) {
+            return mopt->default_value;
+        }
+        if ((lopt = dynamic_cast<const detail::LiveOption *>(option))) {
+            return lopt->default_text();
+        }
+        return std::string();
+    }
+
+    /// @brief Writes the help line of an option, if it is shown in the given tier.
+    /// @param ss The stream the line is written to.
+    /// @param option The option, not a separator.
+    /// @param tier The most detailed tier shown, which also sets the width of the columns.
+    void writeHelp(std::ostream &ss, const detail::Option *option, HelpTier tier) const
+    {
+        if (option->tier > tier) {
+            return;
+        }
+        const detail::MultiOption *mopt   = nullptr;
+        const detail::ProfileOption *popt = nullptr;
+        ss << "[" << std::setw(options.getLongestShortOption<int>(tier)) << std::left << option->opt_short << "] ";
+        ss << std::setw(options.getLongestLongOption<int>(tier)) << std::left << option->opt_long;
+        ss << " (" << std::setw(options.getLongestValue<int>(tier)) << std::right;
+        this->writeValue(ss, option);
+        ss << ") : ";
+        ss << option->description;
+        if ((mopt = dynamic_cast<const detail::MultiOption *>(option))) {
+            ss << " " << mopt->print_list();
+        } else if ((popt = dynamic_cast<const detail::ProfileOption *>(option))) {
+            ss << " " << popt->print_list();
+        }
+        ss << "\n";
+    }
+
+    /// @brief Writes the current value of an option, as text.
+    /// @param os The output stream.
+    /// @param option The option.
+    void writeValue(std::ostream &os, const detail::Option *option) const
+    {
+        const detail::ValueOption *vopt     = nullptr;
+        const detail::ToggleOption *topt    = nullptr;
+        const detail::MultiOption *mopt     = nullptr;
+        const detail::ProfileOption *popt   = nullptr;
+        const detail::CompositeOption *copt = nullptr;
+        const detail::LiveOption *lopt      = nullptr;
+        if ((vopt = dynamic_cast<const detail::ValueOption *>(option))) {
+            os << vopt->value;
+        } else if ((topt = dynamic_cast<const detail::ToggleOption *>(option))) {
+            os << (topt->toggled ? "true" : "false");
+        } else if ((mopt = dynamic_cast<const detail::MultiOption *>(option))) {
+            os << mopt->selected_value;
+        } else if ((popt = dynamic_cast<const detail::ProfileOption *>(option))) {
+            os << popt->selected_profile;
+        } else if ((copt = dynamic_cast<const detail::CompositeOption *>(option))) {
+            os << copt->format_values();
+        } else if ((lopt = dynamic_cast<const detail::LiveOption *>(option))) {
+            os << lopt->load_text();
+        }
+    }
+
+    /// @brief Writes the current value of an option, as a JSON value.
+    /// @param os The output stream.
+    /// @param option The option.
+    /// @details Toggles and live options keep their type, any other value is a string.
+    void writeJsonValue(std::ostream &os, const detail::Option *option) const
+    {
+        const detail::ValueOption *vopt  = nullptr;
+        const detail::ToggleOption *topt = nullptr;
+        const detail::MultiOption *mopt  = nullptr;
+        const detail::LiveOption *lopt   = nullptr;
+        double number                    = 0;
+        if ((vopt = dynamic_cast<const detail::ValueOption *>(option))) {
+            Parser::writeJsonString(os, vopt->value);
+        } else if ((topt = dynamic_cast<const detail::ToggleOption *>(option))) {
+            os << (topt->toggled ? "true" : "false");
+        } else if ((mopt = dynamic_cast<const detail::MultiOption *>(option))) {
+            Parser::writeJsonString(os, mopt->selected_value);
+        } else if ((lopt = dynamic_cast<const detail::LiveOption *>(option))) {
+            const std::string text = lopt->load_text();
+            // Numbers are written as they are, unless JSON cannot represent them (e.g., "nan").
+            if ((text == "true") || (text == "false") || (value_traits<double>::parse(text, number) && std::isfinite(number))) {
+                os << text;
+            } else {
+                Parser::writeJsonString(os, text);
+            }
+        } else {
+            std::stringstream ss;
+            this->writeValue(ss, option);
+            Parser::writeJsonString(os, ss.str());
+        }
+    }
+
+    /// @brief Writes a text as a JSON string, quoted and escaped.
+    /// @param os The output stream.
+    /// @param text The text.
+    static void writeJsonString(std::ostream &os, std::string_view text)
+    {
+        static const char hex[] = "0123456789abcdef";
+        os << '"';
+        for (char c : text) {
+            switch (c) {
+            case '"':
+                os << "\\\"";
+                break;
+            case '\\':
+                os << "\\\\";
+                break;
+            case '\n':
+                os << "\\n";
+                break;
+            case '\r':
+                os << "\\r";
+                break;
+            case '\t':
+                os << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    os << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+                } else {
+                    os << c;
+                }
+                break;
+            }
+        }
+        os << '"';
+    }
+
+    /// @brief The first occurrences of the short and the long version of an option.
+    struct Occurrence {
+        /// @brief The value following the first occurrence of the short version.
+        std::string_view short_value;
+        /// @brief The value following the first occurrence of the long version.
+        std::string_view long_value;
+        /// @brief Whether the short version was found.
+        bool short_found = false;
+        /// @brief Whether the long version was found.
+        bool long_found = false;
+
+        /// @brief Records an occurrence, unless the same version was already found.
+        /// @param event The event describing the occurrence.
+        /// @param is_short Whether the event refers to the short version.
+        inline void record(const detail::ParseEvent &event, bool is_short)
+        {
+            if (is_short && !short_found) {
+                short_found = true;
+                short_value = event.value;
+            } else if (!is_short && !long_found) {
+                long_found = true;
+                long_value = event.value;
+            }
+        }
+
+        /// @brief Returns the value of the short version if present, or the one of the long version.
+        inline std::string_view getValue() const
+        {
+            return short_value.empty() ? long_value : short_value;
+        }
+
+        /// @brief Tells whether either version was found.
+        inline bool isFound() const
+        {
+            return short_found || long_found;
+        }
+    };
+
+    /// @brief How the value of a derived option is computed.
+    struct Derivation {
+        /// @brief The slots of the options the value is derived from.
+        std::vector<std::size_t> dependencies;
+        /// @brief Computes the value, as a string.
+        std::function<std::string(const Parser &)> compute;
+        /// @brief Whether the value must be computed on the next read.
+        bool pending;
+    };
+
+    /// @brief An observer, with the options it observes.
+    struct Subscription {
+        /// @brief The slot of the option, or of the separator opening the section.
+        std::size_t slot;
+        /// @brief Whether the whole section following the separator is observed.
+        bool group;
+        /// @brief The observer.
+        observer_t observer;
+    };
+
+    /// @brief Returns the slots of the options observed by at least one subscription.
+    /// @return The slots, sorted and without duplicates.
+    std::vector<std::size_t> getObservedSlots() const
+    {
+        std::vector<std::size_t> slots;
+        for (const Subscription &subscription : subscriptions) {
+            if (!subscription.group) {
+                slots.push_back(subscription.slot);
+                continue;
+            }
+            for (std::size_t slot = subscription.slot + 1, end = options.getSectionEnd(subscription.slot); slot < end; ++slot) {
+                slots.push_back(slot);
+            }
+        }
+        std::sort(slots.begin(), slots.end());
+        slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+        return slots;
+    }
+
+    /// @brief Saves the current value of the given options, computing the derived ones.
+    /// @param slots The slots of the options.
+    /// @return The values, in the order of `slots`, as accepted by `holdsValue`.
+    std::vector<std::string> saveValues(const std::vector<std::size_t> &slots) const
+    {
+        std::vector<std::string> values;
+        values.reserve(slots.size());
+        for (std::size_t slot : slots) {
+            this->evaluate(slot);
+            const detail::Option *option = options.getOptionAt(slot);
+            if (auto lopt = dynamic_cast<const detail::LiveOption *>(option)) {
+                values.push_back(lopt->save());
+            } else {
+                values.push_back(detail::OptionList::getValue(option));
+            }
+        }
+        return values;
+    }
+
+    /// @brief Tells whether an option still holds a saved value, comparing typed values.
+    /// @param slot The slot of the option.
+    /// @param saved The value saved by `saveValues`.
+    /// @return True if the value did not change.
+    bool holdsValue(std::size_t slot, const std::string &saved) const
+    {
+        this->evaluate(slot);
+        const detail::Option *option = options.getOptionAt(slot);
+        if (auto vopt = dynamic_cast<const detail::ValueOption *>(option)) {
+            return vopt->holds(saved);
+        }
+        if (auto lopt = dynamic_cast<const detail::LiveOption *>(option)) {
+            return lopt->holds(saved);
+        }
+        return detail::OptionList::getValue(option) == saved;
+    }
+
+    /// @brief Calls the observers of the options whose value changed.
+    /// @param observed The slots of the observed options.
+    /// @param previous Their values before parsing, in the same order.
+    void notifyObservers(const std::vector<std::size_t> &observed, const std::vector<std::string> &previous) const
+    {
+        std::vector<bool> changed(options.size(), false);
+        bool any_changed = false;
+        for (std::size_t i = 0; i < observed.size(); ++i) {
+            changed[observed[i]] = !this->holdsValue(observed[i], previous[i]);
+            any_changed |= changed[observed[i]];
+        }
+        if (!any_changed) {
+            return;
+        }
+        std::vector<std::size_t> slots;
+        for (const Subscription &subscription : subscriptions) {
+            slots.clear();
+            if (!subscription.group) {
+                if (changed[subscription.slot]) {
+                    slots.push_back(subscription.slot);
+                }
+            } else {
+                for (std::size_t slot = subscription.slot + 1, end = options.getSectionEnd(subscription.slot); slot < end; ++slot) {
+                    if (changed[slot]) {
+                        slots.push_back(slot);
+                    }
+                }
+            }
+            if (!slots.empty()) {
+                subscription.observer(slots);
+            }
+        }
+    }
+
+    /// @brief Tells whether an option depends, directly or transitively, on another one.
+    /// @param slot The slot of the option.
+    /// @param target The slot of the other option.
+    /// @return True if `slot` is `target`, or is derived from it.
+    bool dependsOn(std::size_t slot, std::size_t target) const
+    {
+        if (slot == target) {
+            return true;
+        }
+        auto derivation = derivations.find(slot);
+        if (derivation != derivations.end()) {
+            for (std::size_t dependency : derivation->second.dependencies) {
+                if (this->dependsOn(dependency, target)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /// @brief Reads the value of an option for a `Handle`.
+    /// @tparam T The type of the value.
+    /// @param slot The slot of the option.
+    /// @return The value, a view for string options.
+    template <typename T>
+    inline typename Handle<T>::value_t readHandle(std::size_t slot) const
+    {
+        if (!derivations.empty()) {
+            this->evaluate(slot);
+        }
+        if constexpr (std::is_same_v<T, std::string>) {
+            return detail::OptionList::readView(options.getOptionAt(slot));
+        } else {
+            return detail::OptionList::readOption<T>(options.getOptionAt(slot));
+        }
+    }
+
+    /// @brief Tells where the current value of an option comes from.
+    /// @param slot The slot of the option.
+    /// @return The origin, `ValueOrigin::runtime` for a live option changed at runtime.
+    /// @details The runtime origin is a flag of the option, rather than an
+    /// entry of `origins`, because it is set by the control thread.
+    ValueOrigin originAt(std::size_t slot) const
+    {
+        auto lopt = dynamic_cast<const detail::LiveOption *>(options.getOptionAt(slot));
+        if (lopt && lopt->changed.load(std::memory_order_relaxed)) {
+            return ValueOrigin::runtime;
+        }
+        return (slot < origins.size()) ? origins[slot] : ValueOrigin::default_value;
+    }
+
+    /// @brief Computes the value of a derived option, if it is pending.
+    /// @param slot The slot of the option, which may not be derived.
+    void evaluate(std::size_t slot) const
+    {
+        auto derivation = derivations.find(slot);
+        if ((derivation == derivations.end()) || !derivation->second.pending || !option_parsed) {
+            return;
+        }
+        derivation->second.pending = false;
+        auto vopt                  = static_cast<detail::ValueOption *>(options.getOptionAt(slot));
+        vopt->value                = derivation->second.compute(*this);
+        // The option may have been added after the last parse, and not be tracked yet.
+        if (slot >= origins.size()) {
+            origins.resize(options.size(), ValueOrigin::default_value);
+        }
+        origins[slot] = ValueOrigin::derived;
+        options.updateLongestValue(vopt->value.length(), vopt->tier);
+    }
+
+    /// @brief Publishes the values of the options readable from signal handlers.
+    /// @details Derived options are computed first, as a handler cannot do it.
+    void publishSignalSafe()
+    {
+        if (!derivations.empty()) {
+            for (std::size_t slot : signal_table.getSlots()) {
+                this->evaluate(slot);
+            }
+        }
+        signal_table.publish(options);
+    }
+
+    /// @brief A value read from a configuration source.
+    struct SourceValue {
+        /// @brief The slot of the option.
+        std::size_t slot;
+        /// @brief The value, as text.
+        std::string value;
+        /// @brief The position of the source the value comes from.
+        std::size_t source;
+    };
+
+    /// @brief Tells whether a text is a valid value for an option, without assigning it.
+    /// @param option The option.
+    /// @param text The text.
+    /// @return True if the option would accept the text.
+    static bool acceptsValue(const detail::Option *option, std::string_view text)
+    {
+        const detail::ValueOption *vopt;
+        const detail::MultiOption *mopt;
+        const detail::LiveOption *lopt;
+        const detail::CompositeOption *copt;
+        bool toggled;
+        if ((vopt = dynamic_cast<const detail::ValueOption *>(option))) {
+            return !vopt->validator || vopt->validator(text);
+        }
+        if (dynamic_cast<const detail::ToggleOption *>(option)) {
+            return value_traits<bool>::parse(text, toggled);
+        }
+        if ((mopt = dynamic_cast<const detail::MultiOption *>(option))) {
+            return mopt->isValueAllowed(std::string(text));
+        }
+        if ((lopt = dynamic_cast<const detail::LiveOption *>(option))) {
+            return lopt->accepts(text);
+        }
+        if ((copt = dynamic_cast<const detail::CompositeOption *>(option))) {
+            return copt->accepts(text);
+        }
+        return true;
+    }
+
+    /// @brief Checks the values about to be assigned by the sources, the profile and the command line.
+    /// @param found The occurrences on the command line.
+    /// @return The selected profile, empty if none.
+    /// @throws std::invalid_argument if a value is not valid for its option, or the profile does not exist.
+    /// @details Called before any option is modified, so that assigning the
+    /// values afterwards cannot fail.
+    std::string checkValues(const std::vector<Occurrence> &found) const
+    {
+        std::string profile;
+        for (const SourceValue &entry : source_values) {
+            const detail::Option *option = options.getOptionAt(entry.slot);
+            if (entry.slot == profile_slot) {
+                profile = entry.value;
+            } else if (!Parser::acceptsValue(option, entry.value) && !(dynamic_cast<const detail::CompositeOption *>(option) && found[entry.slot].isFound())) {
+                throw std::invalid_argument("Value \"" + entry.value + "\" from " + sources[entry.source]->name() + " is not valid for option " + option->opt_long);
+            }
+        }
+        for (std::size_t slot = 0; slot < options.size(); ++slot) {
+            const detail::Option *option = options.getOptionAt(slot);
+            std::string_view value       = found[slot].getValue();
+            const detail::MultiOption *mopt;
+            if (value.empty() || dynamic_cast<const detail::CompositeOption *>(option)) {
+                continue;
+            }
+            if (slot == profile_slot) {
+                profile.assign(value.data(), value.size());
+            } else if ((mopt = dynamic_cast<const detail::MultiOption *>(option)) && !mopt->isValueAllowed(std::string(value))) {
+                throw std::invalid_argument("Value \"" + std::string(value) + "\" is not in the list of allowed values: " + mopt->print_list());
+            } else if (!Parser::acceptsValue(option, value)) {
+                throw std::invalid_argument("Value \"" + std::string(value) + "\" is not valid for option " + option->opt_long);
+            }
+        }
+        if (!profile.empty()) {
+            auto popt                                      = static_cast<const detail::ProfileOption *>(options.getOptionAt(profile_slot));
+            const detail::ProfileOption::Profile *selected = popt->findProfile(profile);
+            if (!selected) {
+                throw std::invalid_argument("Profile \"" + profile + "\" is not in the list of profiles: " + popt->print_list());
+            }
+            // The values listed in a file were not checked when the profile was added.
+            for (const detail::ProfileOption::Setting &setting : selected->settings) {
+                auto mopt = dynamic_cast<const detail::MultiOption *>(options.getOptionAt(setting.slot));
+                if (mopt && mopt->value_file && !mopt->isValueAllowed(setting.value)) {
+                    throw std::invalid_argument("Profile \"" + profile + "\" sets " + mopt->opt_long + " to \"" + setting.value + "\", which is not in the list of allowed values: " + mopt->print_list());
+                }
+            }
+        }
+        return profile;
+    }
+
+    /// @brief Copies the values read from the configuration sources into their options.
+    /// @param found The occurrences on the command line, whose tuple options ignore the sources.
+    /// @param preset Marks the slots that received a value.
+    /// @details The values must have been checked by `checkValues`.
+    void applySources(const std::vector<Occurrence> &found, std::vector<bool> &preset)
+    {
+        for (const SourceValue &entry : source_values) {
+            detail::Option *option = options.getOptionAt(entry.slot);
+            detail::ValueOption *vopt;
+            detail::ToggleOption *topt;
+            detail::MultiOption *mopt;
+            detail::LiveOption *lopt;
+            detail::CompositeOption *copt;
+            if ((vopt = dynamic_cast<detail::ValueOption *>(option))) {
+                vopt->value = entry.value;
+            } else if ((topt = dynamic_cast<detail::ToggleOption *>(option))) {
+                value_traits<bool>::parse(entry.value, topt->toggled);
+            } else if ((mopt = dynamic_cast<detail::MultiOption *>(option))) {
+                mopt->selected_value = entry.value;
+            } else if ((lopt = dynamic_cast<detail::LiveOption *>(option))) {
+                lopt->store(entry.value);
+            } else if ((copt = dynamic_cast<detail::CompositeOption *>(option))) {
+                if (!found[entry.slot].isFound()) {
+                    copt->append(entry.value);
+                }
+            } else if (entry.slot == profile_slot) {
+                continue;
+            }
+            options.updateLongestValue(entry.value.length(), option->tier);
+            preset[entry.slot]  = true;
+            origins[entry.slot] = ValueOrigin::source;
+        }
+    }
+
+    /// @brief Copies the values of a profile into their options.
+    /// @param name The name of the profile.
+    /// @param preset Marks the slots that received a value.
+    /// @throws std::invalid_argument if the profile does not exist.
+    /// @details The profile of a parse is checked beforehand by `checkValues`.
+    void applyProfile(const std::string &name, std::vector<bool> &preset)
+    {
+        auto popt                                     = static_cast<detail::ProfileOption *>(options.getOptionAt(profile_slot));
+        const detail::ProfileOption::Profile *profile = popt->findProfile(name);
+        if (!profile) {
+            throw std::invalid_argument("Profile \"" + name + "\" is not in the list of profiles: " + popt->print_list());
+        }
+        popt->selected_profile = name;
+        for (const detail::ProfileOption::Setting &setting : profile->settings) {
+            detail::Option *option = options.getOptionAt(setting.slot);
+            detail::ValueOption *vopt;
+            detail::ToggleOption *topt;
+            detail::MultiOption *mopt;
+            detail::LiveOption *lopt;
+            if ((vopt = dynamic_cast<detail::ValueOption *>(option))) {
+                vopt->value = setting.value;
+            } else if ((topt = dynamic_cast<detail::ToggleOption *>(option))) {
+                topt->toggled = setting.toggled;
+            } else if ((mopt = dynamic_cast<detail::MultiOption *>(option))) {
+                mopt->selected_value = setting.value;
+            } else if ((lopt = dynamic_cast<detail::LiveOption *>(option))) {
+                lopt->store(setting.value);
+            }
+            options.updateLongestValue(setting.value.length(), option->tier);
+            preset[setting.slot]  = true;
+            origins[setting.slot] = ValueOrigin::profile;
+        }
+    }
+
+    /// @brief Builds the tokenizer, tracing the time it takes.
+    /// @param _tracer The sink to report to, can be `nullptr`.
+    /// @param argc The number of command-line arguments.
+    /// @param argv The array of command-line arguments.
+    /// @return The tokenizer.
+    static detail::Tokenizer tokenize(TraceSink *_tracer, int argc, char **argv)
+    {
+        detail::TraceScope scope(_tracer, "tokenize");
+        detail::Tokenizer result(argc, argv);
+        if (_tracer) {
+            _tracer->counter("tokens", result.size());
+        }
+        return result;
+    }
+
+    /// @brief Records that an option was found on the command line.
+    /// @param option The option that was found.
+    /// @param matched The number of options found so far, incremented by one.
+    inline void countHit(const detail::Option *option, std::size_t &matched) const
+    {
+#ifdef CMDLP_ACCESS_STATS
+        option->stats->countHit();
+#else
+        (void)option;
+#endif
+        ++matched;
+    }
+
+    /// @brief Opens the registration phase, unless it is already open.
+    /// @details Consecutive calls to the `add` functions are reported as a single phase.
+    void beginRegistration()
+    {
+        help_index.clear();
+        if (tracer && !registering) {
+            tracer->begin("register");
+            registering = true;
+        }
+    }
+
+    /// @brief Closes the registration phase, if it is open.
+    /// @details Reports the number of registered options once, at the end of the phase.
+    void endRegistration() const
+    {
+        if (registering) {
+            tracer->counter("options", options.size());
+            tracer->end("register");
+            registering = false;
+        }
+    }
+
+    /// @brief The sink receiving the tracing events, `nullptr` when tracing is disabled.
+    TraceSink *tracer;
+    /// @brief Whether the registration phase is currently being traced.
+    mutable bool registering;
     /// @brief Tokenizer for parsing command-line arguments.
     detail::Tokenizer tokenizer;
     /// @brief The list of registered options.
     detail::OptionList options;
     /// @brief Indicates whether options have been parsed.
     bool option_parsed;
+    /// @brief The cached fingerprint of the options, zero when it must be recomputed.
+    mutable uint64_t schema_fingerprint;
+    /// @brief The slot of the option selecting the profiles, `npos` if not registered.
+    std::size_t profile_slot;
+    /// @brief The derived options, indexed by slot.
+    mutable std::unordered_map<std::size_t, Derivation> derivations;
+    /// @brief The observers of the option changes, in subscription order.
+    std::vector<Subscription> subscriptions;
+    /// @brief The words of the names and descriptions, built on first search.
+    mutable detail::HelpIndex help_index;
+    /// @brief The values readable from signal handlers.
+    detail::SignalTable signal_table;
+    /// @brief The configuration sources, in increasing order of precedence.
+    std::vector<std::shared_ptr<const ConfigSource>> sources;
+    /// @brief The values read from the sources, merged by precedence.
+    std::vector<SourceValue> source_values;
+    /// @brief Whether the sources have been loaded since they were declared.
+    bool sources_loaded;
+    /// @brief Where the value of each option comes from, filled while parsing.
+    mutable std::vector<ValueOrigin> origins;
 };
 
+template <typename T>
+inline typename Handle<T>::value_t Handle<T>::get() const
+{
+    return parser->template readHandle<T>(slot);
+}
+
 } // namespace cmdlp
\ No newline at end of file
@@ -0,0 +1,304 @@
+/// @file server.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines a client/server launch mode, where short invocations are
+/// forwarded to a long-running process that has already built its options.
+
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include "detail/socket.hpp"
+#include "parser.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+
+#include <sys/wait.h>
+
+extern char **environ;
+
+namespace cmdlp
+{
+
+/// @class Server
+/// @brief Serves invocations forwarded by `forwardToServer` over a Unix socket.
+/// @details The server registers its options and performs any expensive
+/// initialization once, then waits for clients. Each client sends its
+/// arguments, its environment and its standard streams; the server forks,
+/// parses the arguments against the already-built options and runs the
+/// command in the child, with the client streams in place of its own. The
+/// exit status of the command is sent back to the client.
+///
+/// Running each command in a forked child keeps invocations isolated from
+/// each other, and lets `Parser::parseOptions` terminate the command on a
+/// missing required option without bringing the server down. The child
+/// takes the environment and the working directory of the client, in place
+/// of those of the server. Only clients running as the same user as the
+/// server are served.
+class Server {
+public:
+    /// @brief The command run for each invocation.
+    /// @details Receives the parser with the client arguments already parsed,
+    /// and returns the exit status of the invocation.
+    using handler_t = std::function<int(Parser &)>;
+
+    /// @brief Binds the server to a Unix socket.
+    /// @param _parser The parser holding the registered options.
+    /// @param _path The filesystem path of the socket, replaced if it is a stale socket.
+    /// @throws std::runtime_error if the socket cannot be created, or
+    /// something other than a socket exists at the path.
+    Server(Parser &_parser, std::string _path)
+        : parser(_parser),
+          path(std::move(_path)),
+          listen_fd(-1),
+          owner(::getpid())
+    {
+        sockaddr_un address = detail::make_socket_address(path);
+        listen_fd           = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listen_fd < 0) {
+            throw detail::system_error("Cannot create socket");
+        }
+        try {
+            detail::remove_stale_socket(path);
+        } catch (...) {
+            ::close(listen_fd);
+            throw;
+        }
+        if ((::bind(listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) || (::listen(listen_fd, 64) < 0)) {
+            std::runtime_error error = detail::system_error("Cannot listen on " + path);
+            ::close(listen_fd);
+            throw error;
+        }
+    }
+
+    /// @brief Closes the socket and removes it from the filesystem.
+    /// @details Only the process that created the socket removes it, a child
+    /// destroying its copy of the server leaves the socket to the server.
+    ~Server()
+    {
+        ::close(listen_fd);
+        if (::getpid() == owner) {
+            ::unlink(path.c_str());
+        }
+    }
+
+    Server(const Server &)            = delete;
+    Server &operator=(const Server &) = delete;
+
+    /// @brief Serves invocations until an error occurs.
+    /// @param handler The command run for each invocation.
+    void serve(const handler_t &handler)
+    {
+        while (this->serveOne(handler)) {}
+    }
+
+    /// @brief Waits for a single invocation and starts serving it.
+    /// @param handler The command run for the invocation.
+    /// @return False if the server could not accept connections anymore.
+    /// @details Returns as soon as the invocation has been handed to a child process.
+    bool serveOne(const handler_t &handler)
+    {
+        // Reap the children that served previous invocations.
+        while (::waitpid(-1, nullptr, WNOHANG) > 0) {}
+        int client_fd = ::accept(listen_fd, nullptr, nullptr);
+        if (client_fd < 0) {
+            return errno == EINTR;
+        }
+        // Other users could otherwise run commands with the privileges of the server.
+        uid_t uid;
+        if (!detail::peer_uid(client_fd, uid) || (uid != ::geteuid())) {
+            ::close(client_fd);
+            return true;
+        }
+        // Flush pending output, otherwise the child would write it again.
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(nullptr);
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            ::close(listen_fd);
+            ::_exit(this->supervise(client_fd, handler));
+        }
+        ::close(client_fd);
+        return pid > 0;
+    }
+
+private:
+    /// @brief Receives an invocation, runs it in a child process, and reports its exit status.
+    /// @param client_fd The connection with the client.
+    /// @param handler The command run for the invocation.
+    /// @return The exit status of the supervising process.
+    int supervise(int client_fd, const handler_t &handler)
+    {
+        std::vector<int> fds(3, -1);
+        std::vector<std::string> arguments, environment, directory;
+        if (!detail::recv_fds(client_fd, fds)) {
+            return 1;
+        }
+        if (!detail::read_strings(client_fd, arguments) ||
+            !detail::read_strings(client_fd, environment) ||
+            !detail::read_strings(client_fd, directory, 1) ||
+            (directory.size() != 1)) {
+            for (int fd : fds) {
+                ::close(fd);
+            }
+            return 1;
+        }
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            ::close(client_fd);
+            Server::run(parser, fds, arguments, environment, directory.front(), handler);
+        }
+        for (int fd : fds) {
+            ::close(fd);
+        }
+        int32_t status = 1;
+        int wstatus;
+        if ((pid > 0) && (::waitpid(pid, &wstatus, 0) == pid)) {
+            status = WIFEXITED(wstatus) ? WEXITSTATUS(wstatus) : (128 + WTERMSIG(wstatus));
+        }
+        detail::write_all(client_fd, &status, sizeof(status));
+        ::close(client_fd);
+        return 0;
+    }
+
+    /// @brief Runs the command with the environment, the working directory and the streams of the client.
+    /// @param parser The parser holding the registered options.
+    /// @param fds The standard input, output and error of the client.
+    /// @param arguments The arguments of the client, program name included.
+    /// @param environment The environment of the client, as `NAME=VALUE` entries.
+    /// @param directory The working directory of the client.
+    /// @param handler The command to run.
+    /// @details Errors are reported on the standard error of the client, and
+    /// end the command with status 1. The process ends with `_exit` once the
+    /// streams are flushed, so that the exit handlers and the static
+    /// destructors of the server (e.g., of a static `Server`, which would
+    /// remove its socket) do not run in the child.
+    [[noreturn]] static void run(Parser &parser,
+                                 const std::vector<int> &fds,
+                                 std::vector<std::string> &arguments,
+                                 const std::vector<std::string> &environment,
+                                 const std::string &directory,
+                                 const handler_t &handler)
+    {
+        for (int i = 0; i < 3; ++i) {
+            int fd = fds[static_cast<std::size_t>(i)];
+            if (fd != i) {
+                ::dup2(fd, i);
+                ::close(fd);
+            }
+        }
+        Server::replaceEnvironment(environment);
+        if (::chdir(directory.c_str()) < 0) {
+            std::cerr << detail::system_error("Cannot change directory to " + directory).what() << "\n";
+            Server::terminate(1);
+        }
+        std::vector<char *> argv;
+        for (std::string &argument : arguments) {
+            argv.push_back(&argument[0]);
+        }
+        int status = 1;
+        try {
+            parser.setArguments(static_cast<int>(argv.size()), argv.data());
+            parser.parseOptions();
+            status = handler(parser);
+        } catch (const std::exception &error) {
+            std::cerr << error.what() << "\n";
+        }
+        Server::terminate(status);
+    }
+
+    /// @brief Ends the process running a command, without running the exit handlers of the server.
+    /// @param status The exit status of the command.
+    [[noreturn]] static void terminate(int status)
+    {
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(nullptr);
+        ::_exit(status);
+    }
+
+    /// @brief Replaces the environment of the process with the one of the client.
+    /// @param environment The environment of the client, as `NAME=VALUE` entries.
+    static void replaceEnvironment(const std::vector<std::string> &environment)
+    {
+#if defined(__APPLE__)
+        // There is no clearenv, remove the variables one by one.
+        std::vector<std::string> names;
+        for (char **entry = environ; entry && *entry; ++entry) {
+            names.emplace_back(*entry, std::strcspn(*entry, "="));
+        }
+        for (const std::string &name : names) {
+            ::unsetenv(name.c_str());
+        }
+#else
+        ::clearenv();
+#endif
+        for (const std::string &entry : environment) {
+            std::size_t separator = entry.find('=');
+            if ((separator != std::string::npos) && (separator > 0)) {
+                ::setenv(entry.substr(0, separator).c_str(), entry.c_str() + separator + 1, 1);
+            }
+        }
+    }
+
+    /// @brief The parser holding the registered options.
+    Parser &parser;
+    /// @brief The filesystem path of the socket.
+    std::string path;
+    /// @brief The listening socket.
+    int listen_fd;
+    /// @brief The process that created the socket.
+    pid_t owner;
+};
+
+/// @brief Forwards an invocation to a running `Server`.
+/// @param path The filesystem path of the server socket.
+/// @param argc The number of command-line arguments.
+/// @param argv The array of command-line arguments.
+/// @param envp The environment to forward, defaults to the one of the process.
+/// @return The exit status of the invocation, or -1 if no server is listening on `path`.
+/// @details The server writes directly to the standard streams of the caller,
+/// which only waits for the exit status. When -1 is returned nothing has been
+/// run, and the caller can fall back to parsing and running the command itself.
+inline int forwardToServer(const std::string &path, int argc, char **argv, char **envp = environ)
+{
+    sockaddr_un address = detail::make_socket_address(path);
+    int fd              = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) {
+        ::close(fd);
+        return -1;
+    }
+    std::vector<std::string> arguments(argv, argv + argc), environment;
+    for (char **entry = envp; entry && *entry; ++entry) {
+        environment.emplace_back(*entry);
+    }
+    std::vector<char> directory(4096);
+    while (!::getcwd(directory.data(), directory.size())) {
+        if (errno != ERANGE) {
+            // The server reports that it cannot change to an empty directory.
+            directory.assign(1, '\0');
+            break;
+        }
+        directory.resize(directory.size() * 2);
+    }
+    int32_t status = 1;
+    if (!detail::send_fds(fd, { STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO }) ||
+        !detail::write_strings(fd, arguments) ||
+        !detail::write_strings(fd, environment) ||
+        !detail::write_strings(fd, { directory.data() }) ||
+        !detail::read_all(fd, &status, sizeof(status))) {
+        status = 1;
+    }
+    ::close(fd);
+    return status;
+}
+
+} // namespace cmdlp
+
+#endif
@@ -0,0 +1,164 @@
+/// @file source.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the configuration sources read before the command line (files, environment).
+
+#pragma once
+
+#include "detail/option_list.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cmdlp
+{
+
+/// @class ConfigSource
+/// @brief A source of option values, such as a configuration file or the environment.
+/// @details Sources are declared with `Parser::addSource` and read by
+/// `Parser::loadSources`, concurrently with each other: `load` runs on a
+/// worker thread, must not modify shared state, and may only read the options
+/// it is given. Subclass it to read other formats.
+class ConfigSource {
+public:
+    /// @brief A value read from the source.
+    struct Setting {
+        /// @brief The name of the option, as found in the source (e.g., "--log-level").
+        std::string name;
+        /// @brief The value, as text.
+        std::string value;
+    };
+
+    /// @brief Virtual destructor.
+    virtual ~ConfigSource() = default;
+
+    /// @brief Returns a name identifying the source in error messages (e.g., its path).
+    virtual std::string name() const = 0;
+
+    /// @brief Reads and tokenizes the source.
+    /// @param options The registered options, to resolve names or to look up only the needed keys.
+    /// @param settings The settings read, in the order they appear in the source.
+    /// @throws std::runtime_error if the source exists but cannot be read.
+    /// @throws std::invalid_argument if the source is malformed.
+    virtual void load(const detail::OptionList &options, std::vector<Setting> &settings) const = 0;
+};
+
+/// @class FileSource
+/// @brief Reads "name = value" lines from a file.
+/// @details Names are long option names, with or without their leading
+/// dashes. Blank lines and lines starting with '#' are skipped, and spaces
+/// around names and values are ignored. Toggles take "true" or "false".
+class FileSource : public ConfigSource {
+public:
+    /// @brief Constructs a source reading a file.
+    /// @param _path The path of the file.
+    /// @param _optional Whether a missing file is silently skipped.
+    explicit FileSource(std::string _path, bool _optional = true)
+        : path(std::move(_path)),
+          optional(_optional)
+    {
+    }
+
+    virtual std::string name() const override
+    {
+        return path;
+    }
+
+    virtual void load(const detail::OptionList &, std::vector<Setting> &settings) const override
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            if (optional) {
+                return;
+            }
+            throw std::runtime_error("Cannot open configuration file: " + path);
+        }
+        const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        std::size_t number = 0;
+        for (std::size_t begin = 0; begin < text.size(); ++number) {
+            std::size_t end       = std::min(text.find('\n', begin), text.size());
+            std::string_view line = FileSource::trim(std::string_view(text).substr(begin, end - begin));
+            begin                 = end + 1;
+            if (line.empty() || (line[0] == '#')) {
+                continue;
+            }
+            std::size_t equal = line.find('=');
+            if (equal == std::string_view::npos) {
+                throw std::invalid_argument(path + ":" + std::to_string(number + 1) + ": expected name = value");
+            }
+            std::string_view key = FileSource::trim(line.substr(0, equal));
+            key.remove_prefix(std::min(key.find_first_not_of('-'), key.size()));
+            settings.push_back(Setting{ "--" + std::string(key), std::string(FileSource::trim(line.substr(equal + 1))) });
+        }
+    }
+
+private:
+    /// @brief Removes the leading and trailing spaces of a text.
+    static inline std::string_view trim(std::string_view text)
+    {
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+
+    /// @brief The path of the file.
+    std::string path;
+    /// @brief Whether a missing file is silently skipped.
+    bool optional;
+};
+
+/// @class EnvironmentSource
+/// @brief Reads the options from environment variables (e.g., "APP_LOG_LEVEL" for "--log-level").
+/// @details The name of the variable is the prefix followed by the long name
+/// of the option, without dashes, in uppercase, with '-' and '.' replaced by
+/// '_'. Only the registered options are looked up. The environment must not
+/// be modified while the sources are loaded.
+class EnvironmentSource : public ConfigSource {
+public:
+    /// @brief Constructs a source reading the environment.
+    /// @param _prefix The prefix of the variables (e.g., "APP_").
+    explicit EnvironmentSource(std::string _prefix)
+        : prefix(std::move(_prefix))
+    {
+    }
+
+    virtual std::string name() const override
+    {
+        return "environment (" + prefix + "*)";
+    }
+
+    virtual void load(const detail::OptionList &options, std::vector<Setting> &settings) const override
+    {
+        for (detail::OptionList::const_iterator_t it = options.begin(); it != options.end(); ++it) {
+            const std::string &opt_long = (*it)->opt_long;
+            if (opt_long.empty()) {
+                continue;
+            }
+            std::string variable = prefix;
+            for (std::size_t i = opt_long.find_first_not_of('-'); i < opt_long.size(); ++i) {
+                char c = opt_long[i];
+                variable.push_back(((c == '-') || (c == '.')) ? '_' : static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+            }
+            if (const char *value = std::getenv(variable.c_str())) {
+                settings.push_back(Setting{ opt_long, value });
+            }
+        }
+    }
+
+private:
+    /// @brief The prefix of the variables.
+    std::string prefix;
+};
+
+} // namespace cmdlp
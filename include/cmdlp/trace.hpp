@@ -0,0 +1,144 @@
+/// @file trace.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines the tracing interface used to profile the phases of the `Parser`.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace cmdlp
+{
+
+/// @class TraceSink
+/// @brief Receives the begin/end events and the counters emitted by the `Parser`.
+/// @details Event names are string literals owned by the library, they are
+/// valid for the whole lifetime of the program. Events are emitted from the
+/// thread that uses the `Parser`.
+class TraceSink {
+public:
+    /// @brief Virtual destructor.
+    virtual ~TraceSink() = default;
+
+    /// @brief Called when a phase begins.
+    /// @param name The name of the phase (e.g., "parse").
+    virtual void begin(const char *name) = 0;
+
+    /// @brief Called when a phase ends.
+    /// @param name The name of the phase, the same passed to `begin`.
+    virtual void end(const char *name) = 0;
+
+    /// @brief Called to report the value of a counter.
+    /// @param name The name of the counter (e.g., "tokens").
+    /// @param value The current value of the counter.
+    virtual void counter(const char *name, std::size_t value) = 0;
+};
+
+/// @class ChromeTraceSink
+/// @brief A `TraceSink` that writes Chrome trace-event JSON to a file.
+/// @details The resulting file can be loaded in `chrome://tracing` or Perfetto.
+/// The JSON array is closed when the sink is destroyed.
+class ChromeTraceSink : public TraceSink {
+public:
+    /// @brief Opens the output file.
+    /// @param path The path of the file the events are written to.
+    /// @throws std::runtime_error if the file cannot be opened.
+    explicit ChromeTraceSink(const std::string &path)
+        : out(path),
+          start(std::chrono::steady_clock::now()),
+          first(true)
+    {
+        if (!out) {
+            throw std::runtime_error("Cannot open trace file: " + path);
+        }
+        out << "[\n";
+    }
+
+    /// @brief Closes the JSON array and the file.
+    virtual ~ChromeTraceSink()
+    {
+        out << "\n]\n";
+    }
+
+    void begin(const char *name) override
+    {
+        this->writeEvent(name, 'B');
+        out << "}";
+    }
+
+    void end(const char *name) override
+    {
+        this->writeEvent(name, 'E');
+        out << "}";
+    }
+
+    void counter(const char *name, std::size_t value) override
+    {
+        this->writeEvent(name, 'C');
+        out << ",\"args\":{\"" << name << "\":" << value << "}}";
+    }
+
+private:
+    /// @brief Writes the fields shared by all events, leaving the object open.
+    /// @param name The name of the event.
+    /// @param phase The trace-event phase ('B', 'E' or 'C').
+    void writeEvent(const char *name, char phase)
+    {
+        auto ts = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        out << (first ? "" : ",\n");
+        out << "{\"name\":\"" << name << "\",\"cat\":\"cmdlp\",\"ph\":\"" << phase << "\",\"ts\":" << ts << ",\"pid\":1,\"tid\":1";
+        first = false;
+    }
+
+    /// @brief The output file.
+    std::ofstream out;
+    /// @brief The time origin of the trace.
+    std::chrono::steady_clock::time_point start;
+    /// @brief Whether the next event is the first one.
+    bool first;
+};
+
+namespace detail
+{
+
+/// @class TraceScope
+/// @brief Emits a begin event on construction and the matching end event on destruction.
+/// @details Does nothing when no sink is installed.
+class TraceScope {
+public:
+    /// @brief Begins the phase.
+    /// @param _sink The sink to report to, can be `nullptr`.
+    /// @param _name The name of the phase.
+    TraceScope(TraceSink *_sink, const char *_name)
+        : sink(_sink),
+          name(_name)
+    {
+        if (sink) {
+            sink->begin(name);
+        }
+    }
+
+    /// @brief Ends the phase.
+    ~TraceScope()
+    {
+        if (sink) {
+            sink->end(name);
+        }
+    }
+
+    TraceScope(const TraceScope &)            = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    /// @brief The sink to report to.
+    TraceSink *sink;
+    /// @brief The name of the phase.
+    const char *name;
+};
+
+} // namespace detail
+
+} // namespace cmdlp
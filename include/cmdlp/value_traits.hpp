@@ -0,0 +1,308 @@
+/// @file value_traits.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Defines `value_traits`, the customization point converting option values from and to text.
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+// Floating-point `from_chars` and `to_chars` are not provided by all the supported standard libraries.
+#if defined(__cpp_lib_to_chars) && (__cpp_lib_to_chars >= 201611L)
+#define CMDLP_FLOAT_CHARCONV
+#endif
+
+namespace cmdlp
+{
+
+namespace detail
+{
+
+/// @brief Copies a text into a caller-provided buffer, as `snprintf` does.
+/// @param text The text.
+/// @param length The length of the text.
+/// @param buffer The buffer, always null-terminated when `size` is not zero.
+/// @param size The size of the buffer.
+/// @return The length of the text, which was truncated if not smaller than `size`.
+inline std::size_t copy_to_buffer(const char *text, std::size_t length, char *buffer, std::size_t size)
+{
+    if (size > 0) {
+        std::size_t count = (length < size) ? length : (size - 1);
+        std::memcpy(buffer, text, count);
+        buffer[count] = '\0';
+    }
+    return length;
+}
+
+} // namespace detail
+
+/// @struct value_traits
+/// @brief Converts the values of type `T` from and to their text on the command line.
+/// @tparam T The type of the value.
+/// @details Specialize it for your own types to skip the streams:
+/// @code
+/// template <>
+/// struct cmdlp::value_traits<Fixed> {
+///     static bool parse(std::string_view text, Fixed &value);
+///     static std::size_t format(const Fixed &value, char *buffer, std::size_t size);
+/// };
+/// @endcode
+/// `parse` returns false if the whole text is not a valid value, and must not
+/// allocate. `format` behaves like `snprintf`: it writes at most `size`
+/// characters, terminator included, and returns the length of the complete
+/// text. `parse` is used to read and to validate the values, `format` to
+/// store the defaults and the derived values shown by the help. The primary
+/// template falls back to `operator>>` and `operator<<`.
+template <typename T, typename = void>
+struct value_traits {
+    /// @brief Parses a value with `operator>>`.
+    static bool parse(std::string_view text, T &value)
+    {
+        std::istringstream ss{ std::string(text) };
+        ss >> value;
+        return !ss.fail();
+    }
+
+    /// @brief Formats a value with `operator<<`.
+    static std::size_t format(const T &value, char *buffer, std::size_t size)
+    {
+        std::ostringstream ss;
+        ss << value;
+        const std::string text = ss.str();
+        return detail::copy_to_buffer(text.data(), text.size(), buffer, size);
+    }
+};
+
+/// @brief Converts integers, in base 10, without allocating.
+template <typename T>
+struct value_traits<T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value && (sizeof(T) > 1)>> {
+    /// @brief Parses an optionally signed integer, rejecting overflows and trailing characters.
+    static bool parse(std::string_view text, T &value)
+    {
+        using unsigned_t = std::make_unsigned_t<T>;
+        std::size_t i    = 0;
+        bool negative    = false;
+        if (!text.empty() && ((text[0] == '+') || (text[0] == '-'))) {
+            negative = (text[0] == '-');
+            ++i;
+        }
+        if ((i == text.size()) || (negative && std::is_unsigned<T>::value)) {
+            return false;
+        }
+        // The magnitude of the minimum of a signed type exceeds its maximum by one.
+        const unsigned_t limit = static_cast<unsigned_t>(static_cast<unsigned_t>(std::numeric_limits<T>::max()) + (negative ? 1U : 0U));
+        unsigned_t result      = 0;
+        for (; i < text.size(); ++i) {
+            if ((text[i] < '0') || (text[i] > '9')) {
+                return false;
+            }
+            unsigned_t digit = static_cast<unsigned_t>(text[i] - '0');
+            if (result > (limit - digit) / 10) {
+                return false;
+            }
+            result = static_cast<unsigned_t>(result * 10 + digit);
+        }
+        value = (negative && (result > 0)) ? static_cast<T>(-static_cast<T>(result - 1) - 1) : static_cast<T>(result);
+        return true;
+    }
+
+    /// @brief Formats an integer.
+    static std::size_t format(const T &value, char *buffer, std::size_t size)
+    {
+        using unsigned_t = std::make_unsigned_t<T>;
+        char digits[std::numeric_limits<unsigned_t>::digits10 + 2];
+        std::size_t length   = sizeof(digits);
+        bool negative        = (value != 0) && !(value > 0);
+        unsigned_t magnitude = negative ? static_cast<unsigned_t>(0U - static_cast<unsigned_t>(value)) : static_cast<unsigned_t>(value);
+        do {
+            digits[--length] = static_cast<char>('0' + magnitude % 10);
+            magnitude        = static_cast<unsigned_t>(magnitude / 10);
+        } while (magnitude > 0);
+        if (negative) {
+            digits[--length] = '-';
+        }
+        return detail::copy_to_buffer(digits + length, sizeof(digits) - length, buffer, size);
+    }
+};
+
+/// @brief Converts floating-point values in the classic "C" locale, whatever the global locale is.
+/// @details Uses `std::from_chars` and `std::to_chars` where available, which
+/// do not allocate, and streams imbued with the classic locale otherwise.
+template <typename T>
+struct value_traits<T, std::enable_if_t<std::is_floating_point<T>::value>> {
+    /// @brief Parses a floating-point value, rejecting overflows and trailing characters.
+    static bool parse(std::string_view text, T &value)
+    {
+        // A leading plus sign is accepted, as `strtod` does.
+        if ((text.size() > 1) && (text[0] == '+') && (text[1] != '+') && (text[1] != '-')) {
+            text.remove_prefix(1);
+        }
+        if (text.empty()) {
+            return false;
+        }
+#ifdef CMDLP_FLOAT_CHARCONV
+        const char *end            = text.data() + text.size();
+        std::from_chars_result res = std::from_chars(text.data(), end, value);
+        return (res.ec == std::errc()) && (res.ptr == end);
+#else
+        std::istringstream ss{ std::string(text) };
+        ss.imbue(std::locale::classic());
+        ss >> value;
+        return !ss.fail() && (ss.peek() == std::istringstream::traits_type::eof());
+#endif
+    }
+
+    /// @brief Formats a floating-point value with six significant digits, as streams do.
+    static std::size_t format(const T &value, char *buffer, std::size_t size)
+    {
+#ifdef CMDLP_FLOAT_CHARCONV
+        char text[64];
+        std::to_chars_result res = std::to_chars(text, text + sizeof(text), value, std::chars_format::general, 6);
+        return detail::copy_to_buffer(text, static_cast<std::size_t>(res.ptr - text), buffer, size);
+#else
+        std::ostringstream ss;
+        ss.imbue(std::locale::classic());
+        ss << value;
+        const std::string text = ss.str();
+        return detail::copy_to_buffer(text.data(), text.size(), buffer, size);
+#endif
+    }
+};
+
+/// @brief Converts booleans, accepting "1", "0", "true" and "false".
+template <>
+struct value_traits<bool> {
+    /// @brief Parses a boolean.
+    static bool parse(std::string_view text, bool &value)
+    {
+        if ((text == "1") || (text == "true")) {
+            value = true;
+        } else if ((text == "0") || (text == "false")) {
+            value = false;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    /// @brief Formats a boolean as "1" or "0", as streams do.
+    static std::size_t format(const bool &value, char *buffer, std::size_t size)
+    {
+        return detail::copy_to_buffer(value ? "1" : "0", 1, buffer, size);
+    }
+};
+
+/// @brief Converts strings, which accept any text.
+template <>
+struct value_traits<std::string> {
+    /// @brief Copies the text.
+    static bool parse(std::string_view text, std::string &value)
+    {
+        value.assign(text.data(), text.size());
+        return true;
+    }
+
+    /// @brief Copies the string.
+    static std::size_t format(const std::string &value, char *buffer, std::size_t size)
+    {
+        return detail::copy_to_buffer(value.data(), value.size(), buffer, size);
+    }
+};
+
+namespace detail
+{
+
+/// @brief The type an option value of type `T` is converted as, strings for anything string-like.
+template <typename T>
+using value_type_t = std::conditional_t<std::is_convertible<const T &, std::string_view>::value, std::string, T>;
+
+/// @brief Converts a value to the text stored by the options.
+/// @tparam T The type of the value.
+/// @param value The value.
+/// @return The text, formatted by `value_traits`.
+template <typename T>
+inline std::string format_value(const T &value)
+{
+    using traits_t = value_traits<value_type_t<T>>;
+    const value_type_t<T> &converted = value;
+    char buffer[64];
+    std::size_t length = traits_t::format(converted, buffer, sizeof(buffer));
+    if (length < sizeof(buffer)) {
+        return std::string(buffer, length);
+    }
+    std::string text(length + 1, '\0');
+    traits_t::format(converted, &text[0], text.size());
+    text.resize(length);
+    return text;
+}
+
+/// @brief Tells whether a text is a valid value of type `T`.
+/// @tparam T The type of the value.
+/// @param text The text.
+/// @return True if `value_traits<T>::parse` accepts the text.
+template <typename T>
+inline bool validate_value(std::string_view text)
+{
+    T value{};
+    return value_traits<T>::parse(text, value);
+}
+
+/// @brief Any text is a valid string, no copy is needed to tell.
+template <>
+inline bool validate_value<std::string>(std::string_view)
+{
+    return true;
+}
+
+/// @brief Tells whether the values of type `T` can be compared with `operator==`.
+template <typename T, typename = void>
+struct is_equality_comparable : std::false_type {};
+
+/// @brief Specialization for the types providing `operator==`.
+template <typename T>
+struct is_equality_comparable<T, std::void_t<decltype(std::declval<const T &>() == std::declval<const T &>())>> : std::true_type {};
+
+/// @brief Tells whether two texts hold the same value of type `T` (e.g., "0.5" and "0.50").
+/// @tparam T The type of the value.
+/// @param lhs The first text.
+/// @param rhs The second text.
+/// @return True if the converted values are equal. Texts that are not valid
+/// values, or whose type has no `operator==`, are compared as text.
+template <typename T>
+inline bool equal_values(std::string_view lhs, std::string_view rhs)
+{
+    if (lhs == rhs) {
+        return true;
+    }
+    if constexpr (is_equality_comparable<T>::value) {
+        T lhs_value{}, rhs_value{};
+        if (value_traits<T>::parse(lhs, lhs_value) && value_traits<T>::parse(rhs, rhs_value)) {
+            return lhs_value == rhs_value;
+        }
+    }
+    return false;
+}
+
+/// @brief Strings are equal only if their texts are, no copy is needed to tell.
+template <>
+inline bool equal_values<std::string>(std::string_view lhs, std::string_view rhs)
+{
+    return lhs == rhs;
+}
+
+} // namespace detail
+
+} // namespace cmdlp
@@ -0,0 +1,47 @@
+/// @file fuzz_parser.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief libFuzzer entry point for the parser.
+
+#include "cmdlp/parser.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, std::size_t size)
+{
+    // Split the input into NUL-separated arguments.
+    std::vector<std::string> arguments(1, "fuzz");
+    arguments.emplace_back();
+    for (std::size_t i = 0; i < size; ++i) {
+        if (data[i] == '\0') {
+            arguments.emplace_back();
+        } else {
+            arguments.back().push_back(static_cast<char>(data[i]));
+        }
+    }
+    std::vector<char *> argv;
+    for (std::string &argument : arguments) {
+        argv.push_back(&argument[0]);
+    }
+
+    // Required options are left out, since a missing one terminates the process.
+    cmdlp::Parser parser(static_cast<int>(argv.size()), argv.data());
+    parser.addSeparator("Fuzzed options:");
+    parser.addOption("-d", "--double", "Double value", 0.2, false);
+    parser.addOption("-i", "--int", "An integer value", -1, false);
+    parser.addOption("-s", "--string", "A string", "hello", false);
+    parser.addToggle("-v", "--verbose", "Enables verbose output", false);
+    parser.addMultiOption("-m", "--mode", "Select the operation mode.", { "auto", "manual", "test" }, "auto");
+    try {
+        parser.parseOptions();
+    } catch (const std::invalid_argument &) {
+        // Rejected values are an expected outcome.
+    }
+    parser.getOption<double>("--double");
+    parser.getOption<int>("--int");
+    parser.getOption<std::string>("--string");
+    parser.getOption<bool>("--verbose");
+    parser.getOption<std::string>("--mode");
+    parser.getHelp();
+    return 0;
+}
@@ -0,0 +1,34 @@
+/// @file fuzz_tokenizer.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief libFuzzer entry point for the tokenizer.
+
+#include "cmdlp/detail/tokenizer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, std::size_t size)
+{
+    // Split the input into NUL-separated arguments.
+    std::vector<std::string> arguments(1, "fuzz");
+    arguments.emplace_back();
+    for (std::size_t i = 0; i < size; ++i) {
+        if (data[i] == '\0') {
+            arguments.emplace_back();
+        } else {
+            arguments.back().push_back(static_cast<char>(data[i]));
+        }
+    }
+    std::vector<char *> argv;
+    for (std::string &argument : arguments) {
+        argv.push_back(&argument[0]);
+    }
+
+    cmdlp::detail::Tokenizer tokenizer(static_cast<int>(argv.size()), argv.data());
+    // Query every argument back, both as a value-holding option and as a flag.
+    for (const std::string &argument : arguments) {
+        tokenizer.getOption(argument);
+        tokenizer.hasOption(argument);
+    }
+    return 0;
+}
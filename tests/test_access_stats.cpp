@@ -0,0 +1,112 @@
+#include "cmdlp/parser.hpp"
+
+#include <sstream>
+
+#ifndef CMDLP_ACCESS_STATS
+#error "This test must be built with CMDLP_ACCESS_STATS"
+#endif
+
+/// @brief Returns the line of the access report describing an option.
+/// @param report The access report.
+/// @param opt The long name of the option.
+/// @return The line, without its newline, or an empty string if not found.
+static std::string report_line(const std::string &report, const std::string &opt)
+{
+    std::istringstream ss(report);
+    std::string line;
+    while (std::getline(ss, line)) {
+        if (line.compare(0, 4 + opt.size() + 1, "    " + opt + " ") == 0) {
+            return line;
+        }
+    }
+    return "";
+}
+
+/// @brief Checks the counters of an option in the access report.
+/// @return True if the option was read `reads` times, found `hits` times, and is marked unused only if never read.
+static bool check_line(const std::string &report, const std::string &opt, std::size_t reads, std::size_t hits)
+{
+    std::string line = report_line(report, opt);
+    std::istringstream ss(line);
+    std::string name, reads_label, hits_label;
+    std::size_t actual_reads = 0, actual_hits = 0;
+    ss >> name >> reads_label >> actual_reads >> hits_label >> actual_hits;
+    bool unused = line.find("(unused)") != std::string::npos;
+    if ((actual_reads != reads) || (actual_hits != hits) || (unused != (reads == 0))) {
+        std::cerr << "Wrong counters for " << opt << ": `" << line << "`\n";
+        return false;
+    }
+    return true;
+}
+
+/// @brief Checks the report of a parser, then the one of the process.
+static int test_report()
+{
+    std::vector<const char *> arguments = { "test_access_stats", "--threads", "2", "--name", "cmdlp", "--verbose" };
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.addOption("-t", "--threads", "Worker threads", 4, false);
+    parser.addOption("-n", "--name", "A name", "none", false);
+    parser.addOption("-p", "--port", "A port", 80, false);
+    parser.addToggle("-v", "--verbose", "Verbose output", false);
+    parser.addOption("-l", "--level", "A level", 1, false);
+    parser.parseOptions();
+
+    // Each way of reading an option counts as a read.
+    parser.getOption<int>("--threads");
+    parser.getOption<int>("-t");
+    parser.getOptionView("--name");
+    cmdlp::Handle<int> port = parser.getHandle<int>("--port");
+    port.get();
+    port.get();
+    port.get();
+
+    std::ostringstream ss;
+    parser.writeAccessReport(ss);
+    const std::string report = ss.str();
+
+    if (report.compare(0, 33, "cmdlp access report (5 options):\n") != 0) {
+        std::cerr << "Wrong report header\n";
+        return 1;
+    }
+    // Options given on the command line but never read are unused as well.
+    if (!check_line(report, "--port", 3, 0) ||
+        !check_line(report, "--threads", 2, 1) ||
+        !check_line(report, "--name", 1, 1) ||
+        !check_line(report, "--verbose", 0, 1) ||
+        !check_line(report, "--level", 0, 0)) {
+        return 1;
+    }
+    // Options are sorted by number of reads.
+    if (!(report.find("--port") < report.find("--threads") && report.find("--threads") < report.find("--name"))) {
+        std::cerr << "Wrong report order\n";
+        return 1;
+    }
+
+    // The copies of a parser share its counters.
+    {
+        cmdlp::Parser copy(parser);
+        copy.getOption<int>("--level");
+    }
+    std::ostringstream shared;
+    parser.writeAccessReport(shared);
+    if (!check_line(shared.str(), "--level", 1, 0)) {
+        return 1;
+    }
+    return 0;
+}
+
+int main(int, char *[])
+{
+    if (test_report()) {
+        return 1;
+    }
+    // The parser and its copy are reported once, by the report written at exit.
+    std::ostringstream ss;
+    cmdlp::detail::AccessReport::instance().write(ss);
+    const std::string report = ss.str();
+    if ((report.compare(0, 33, "cmdlp access report (5 options):\n") != 0) || !check_line(report, "--level", 1, 0)) {
+        std::cerr << "Wrong process report: `" << report << "`\n";
+        return 1;
+    }
+    return 0;
+}
@@ -1,4 +1,15 @@
 #include "cmdlp/parser.hpp"
+#include "cmdlp/json_source.hpp"
+#include "cmdlp/net.hpp"
+#include "cmdlp/parse_cache.hpp"
+
+#include <clocale>
+#include <csignal>
+#include <cstdio>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
 
 #define TEST_OPTION(OPT, VALUE)                                                          \
     if (OPT != VALUE) {                                                                  \
@@ -7,8 +18,1125 @@
         return 1;                                                                        \
     }
 
+/// @brief A fixed-point value with three decimals, converted without streams.
+struct Fixed {
+    long milli;
+};
+
+template <>
+struct cmdlp::value_traits<Fixed> {
+    static bool parse(std::string_view text, Fixed &value)
+    {
+        std::size_t dot = text.find('.');
+        long integer = 0, fraction = 0;
+        if (!cmdlp::value_traits<long>::parse(text.substr(0, dot), integer) ||
+            ((dot != std::string_view::npos) && ((text.size() - dot != 4) || !cmdlp::value_traits<long>::parse(text.substr(dot + 1), fraction)))) {
+            return false;
+        }
+        value.milli = integer * 1000 + fraction;
+        return true;
+    }
+
+    static std::size_t format(const Fixed &value, char *buffer, std::size_t size)
+    {
+        return static_cast<std::size_t>(std::snprintf(buffer, size, "%ld.%03ld", value.milli / 1000, value.milli % 1000));
+    }
+};
+
+/// @brief Checks that a profile provides the defaults, and that explicit values override them.
+static int test_profiles()
+{
+    std::vector<const char *> arguments = { "test_cmdlp", "--profile", "low-latency", "--threads", "2" };
+
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.addOption("-t", "--threads", "Number of threads", 8, false);
+    parser.addOption("-b", "--batch", "Batch size", 64, true);
+    parser.addToggle("-s", "--spin", "Busy-wait instead of sleeping", false);
+    parser.addToggle("-y", "--yield", "Yield while waiting", true);
+    parser.addProfileOption("-p", "--profile", "Selects a bundle of settings");
+    parser.addProfile("low-latency", { { "--threads", "1" }, { "--batch", "1" }, { "--spin", "true" }, { "--yield", "0" } });
+    parser.addProfile("throughput", { { "--batch", "1024" }, { "--spin", "1" } });
+    bool invalid_toggle = false;
+    try {
+        parser.addProfile("broken", { { "--spin", "yes" } });
+    } catch (const std::invalid_argument &) {
+        invalid_toggle = true;
+    }
+    parser.parseOptions();
+
+    TEST_OPTION(invalid_toggle, true);
+    TEST_OPTION(parser.getOption<int>("--threads"), 2);
+    TEST_OPTION(parser.getOption<int>("--batch"), 1);
+    TEST_OPTION(parser.getOption<bool>("--spin"), true);
+    TEST_OPTION(parser.getOption<bool>("--yield"), false);
+    TEST_OPTION(parser.getOption<std::string>("--profile"), "low-latency");
+
+    std::vector<const char *> throughput = { "test_cmdlp", "--profile", "throughput" };
+    parser.setArguments(static_cast<int>(throughput.size()), const_cast<char **>(throughput.data()));
+    parser.parseOptions();
+    TEST_OPTION(parser.getOption<int>("--batch"), 1024);
+    TEST_OPTION(parser.getOption<bool>("--spin"), true);
+    TEST_OPTION(parser.getOption<bool>("--yield"), true);
+    return 0;
+}
+
+/// @brief Checks that derived options are computed in dependency order, unless set explicitly.
+static int test_derivations()
+{
+    std::vector<const char *> arguments = { "test_cmdlp", "--threads", "6", "--chunk", "5" };
+
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.addOption("-t", "--threads", "Number of threads", 8, false);
+    parser.addOption("-i", "--io-threads", "Number of I/O threads", 4, false);
+    parser.addOption("-l", "--lanes", "Number of lanes", 8, false);
+    parser.addOption("-b", "--buffer", "Buffer size", 4096, false);
+    parser.addOption("-c", "--chunk", "Chunk size", 1024, false);
+    parser.addDerivation("--lanes", { "--io-threads" }, [](const cmdlp::Parser &p) { return 2 * p.getOption<int>("--io-threads"); });
+    parser.addDerivation("--io-threads", { "--threads" }, [](const cmdlp::Parser &p) { return p.getOption<int>("--threads") / 2; });
+    parser.addDerivation("--chunk", { "--buffer" }, [](const cmdlp::Parser &p) { return p.getOption<int>("--buffer") / 4; });
+    bool cycle_detected = false;
+    try {
+        parser.addDerivation("--threads", { "--lanes" }, [](const cmdlp::Parser &) { return 1; });
+    } catch (const std::logic_error &) {
+        cycle_detected = true;
+    }
+    parser.parseOptions();
+
+    TEST_OPTION(cycle_detected, true);
+    TEST_OPTION(parser.getOption<int>("--lanes"), 6);
+    TEST_OPTION(parser.getOption<int>("--io-threads"), 3);
+    TEST_OPTION(parser.getOption<int>("--chunk"), 5);
+
+    // A derived option added after parsing is computed on read, before the next parse tracks it.
+    parser.addOption("-q", "--queue", "Queue length", 0, false);
+    parser.addDerivation("--queue", { "--lanes" }, [](const cmdlp::Parser &p) { return 4 * p.getOption<int>("--lanes"); });
+    TEST_OPTION(parser.getOption<int>("--queue"), 24);
+    TEST_OPTION((parser.getOrigin("--queue") == cmdlp::ValueOrigin::derived), true);
+    return 0;
+}
+
+/// @brief Checks that observers are called once per parse, with the changed slots.
+static int test_observers()
+{
+    std::vector<const char *> arguments = { "test_cmdlp", "--threads", "2", "--log", "a.log" };
+
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.addSeparator("Pool");
+    parser.addOption("-t", "--threads", "Number of threads", 8, false);
+    parser.addOption("-q", "--queue", "Queue length", 16, false);
+    parser.addSeparator("Logging");
+    parser.addOption("-l", "--log", "Log file", "out.log", false);
+    std::size_t pool_calls = 0, pool_changes = 0, log_calls = 0;
+    parser.subscribeGroup("Pool", [&](const std::vector<std::size_t> &slots) {
+        pool_calls += 1;
+        pool_changes += slots.size();
+    });
+    parser.subscribe("--log", [&](const std::vector<std::size_t> &) { log_calls += 1; });
+    parser.parseOptions();
+
+    TEST_OPTION(pool_calls, 1U);
+    TEST_OPTION(pool_changes, 1U);
+    TEST_OPTION(log_calls, 1U);
+
+    // Reload: the log file goes back to its default, the pool is untouched.
+    arguments = { "test_cmdlp", "--threads", "2" };
+    parser.setArguments(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.parseOptions();
+
+    TEST_OPTION(pool_calls, 1U);
+    TEST_OPTION(log_calls, 2U);
+    TEST_OPTION(parser.getOption<std::string>("--log"), "out.log");
+
+    // Values are compared as their type, the same number written differently is no change.
+    parser.addOption("-r", "--ratio", "Sampling ratio", 0.5, false);
+    std::size_t ratio_calls = 0;
+    parser.subscribe("--ratio", [&](const std::vector<std::size_t> &) { ratio_calls += 1; });
+    arguments = { "test_cmdlp", "--threads", "2", "--ratio", "0.50" };
+    parser.setArguments(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.parseOptions();
+    TEST_OPTION(ratio_calls, 0U);
+
+    // A failed reload modifies nothing and notifies no one.
+    arguments = { "test_cmdlp", "--queue", "bad", "--log", "b.log" };
+    parser.setArguments(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    bool rejected = false;
+    try {
+        parser.parseOptions();
+    } catch (const std::invalid_argument &) {
+        rejected = true;
+    }
+    TEST_OPTION(rejected, true);
+    TEST_OPTION(parser.getOption<int>("--threads"), 2);
+    TEST_OPTION(parser.getOption<int>("--queue"), 16);
+    TEST_OPTION(parser.getOption<std::string>("--log"), "out.log");
+    TEST_OPTION((parser.getOrigin("--threads") == cmdlp::ValueOrigin::command_line), true);
+    TEST_OPTION(pool_calls, 1U);
+    TEST_OPTION(log_calls, 2U);
+    return 0;
+}
+
+/// @brief Checks that namespaced options are resolved, exported and reset by subtree.
+static int test_namespaces()
+{
+    std::vector<const char *> arguments = { "test_cmdlp", "--db.pool.size", "32", "--db.host", "remote" };
+
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    cmdlp::Parser::Namespace db   = parser.addNamespace("db");
+    cmdlp::Parser::Namespace pool = db.addNamespace("pool");
+    db.addOption("", "--host", "Database host", "localhost", false);
+    pool.addOption("", "--size", "Pool size", 8, false);
+    pool.addOption("", "--timeout", "Pool timeout", 30, false);
+    parser.addOption("", "--dbx", "Not in the namespace", 1, false);
+    parser.parseOptions();
+
+    TEST_OPTION(parser.getOption<int>("--db.pool.size"), 32);
+    TEST_OPTION(parser.exportNamespace("db").size(), 3U);
+    TEST_OPTION(parser.exportNamespace("db.pool")[1].first, "--db.pool.timeout");
+    TEST_OPTION(parser.exportNamespace("db.none").size(), 0U);
+    cmdlp::SignalSafeHandle size = parser.addSignalSafe("--db.pool.size");
+    parser.resetNamespace("db.pool");
+    TEST_OPTION(parser.getOption<int>("--db.pool.size"), 8);
+    TEST_OPTION(parser.getOption<std::string>("--db.host"), "remote");
+
+    // The reset options report their default origin, everywhere.
+    long long published = 0;
+    TEST_OPTION(parser.readSignalSafe(size, published), true);
+    TEST_OPTION(published, 8LL);
+    TEST_OPTION((parser.getOrigin("--db.pool.size") == cmdlp::ValueOrigin::default_value), true);
+    std::stringstream config;
+    parser.writeEffectiveConfig(config, true);
+    TEST_OPTION(config.str(), "db.host = remote\n");
+    return 0;
+}
+
+/// @brief Checks that fragments are merged in bulk, with or without a prefix.
+static int test_fragments()
+{
+    std::vector<const char *> arguments = { "test_cmdlp", "--codec.level", "9", "-v" };
+
+    cmdlp::Fragment fragment;
+    fragment.addSeparator("Codec");
+    fragment.addOption("-l", "--level", "Compression level", 3, false);
+    fragment.addToggle("-v", "--verbose", "Verbose codec", false);
+
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.addToggle("-v", "--verbose", "Enables verbose output", false);
+    parser.addOption("-x", "--codec.level", "Clashes with the prefixed fragment", 0, false);
+    // Conflicts leave the parser untouched.
+    std::size_t conflicts = 0;
+    for (const char *prefix : { "", "codec" }) {
+        try {
+            parser.merge(fragment, prefix);
+        } catch (const cmdlp::detail::OptionExistException &) {
+            conflicts += 1;
+        }
+    }
+    parser.merge(fragment, "zip");
+    parser.parseOptions();
+
+    TEST_OPTION(conflicts, 2U);
+    TEST_OPTION(parser.getOption<int>("--codec.level"), 9);
+    TEST_OPTION(parser.getOption<int>("--zip.level"), 3);
+    TEST_OPTION(parser.getOption<bool>("--zip.verbose"), false);
+    TEST_OPTION(parser.getOption<bool>("-v"), true);
+
+    // Names that only differ by their dashes collide once prefixed.
+    cmdlp::Fragment clashing;
+    clashing.addOption("-x", "", "Short only", 1, false);
+    clashing.addOption("", "--x", "Long only", 2, false);
+    bool collided = false;
+    try {
+        parser.merge(clashing, "lib");
+    } catch (const cmdlp::detail::OptionExistException &) {
+        collided = true;
+    }
+    TEST_OPTION(collided, true);
+    TEST_OPTION((parser.getHelp().find("--lib.x") == std::string::npos), true);
+    return 0;
+}
+
+/// @brief Checks that the help can be rendered by section and searched by keyword.
+static int test_help_sections()
+{
+    std::vector<const char *> arguments = { "test_cmdlp" };
+
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.addSeparator("Network");
+    parser.addOption("-p", "--port", "Listening port", 80, false);
+    parser.addOption("", "--net.timeout", "Connection timeout", 5, false);
+    parser.addSeparator("Storage");
+    parser.addOption("", "--cache-size", "Size of the disk cache", 64, false);
+    parser.addOption("", "--disk.timeout", "Disk timeout", 10, false);
+
+    std::string network = parser.getHelp("Network");
+    TEST_OPTION((network.find("--port") != std::string::npos), true);
+    TEST_OPTION((network.find("--cache-size") != std::string::npos), false);
+    TEST_OPTION(parser.getHelp("Unknown"), "");
+    std::string timeout = parser.searchHelp("Timeout");
+    TEST_OPTION((timeout.find("--net.timeout") != std::string::npos), true);
+    TEST_OPTION((timeout.find("--disk.timeout") != std::string::npos), true);
+    TEST_OPTION((parser.searchHelp("disk timeout").find("--net.timeout") != std::string::npos), false);
+    TEST_OPTION(parser.searchHelp("bandwidth"), "");
+
+    // Hidden options are neither shown nor stretch the columns of the default help.
+    parser.addOption("", "--an-unreasonably-long-debugging-option", "Debugging knob", 0, false);
+    parser.setTier("--an-unreasonably-long-debugging-option", cmdlp::HelpTier::hidden);
+    parser.setTier("Storage", cmdlp::HelpTier::advanced);
+    std::string basic = parser.getHelp(), hidden = parser.getHelp(cmdlp::HelpTier::hidden);
+    TEST_OPTION((basic.find("--an-unreasonably") != std::string::npos), false);
+    TEST_OPTION((basic.find("--cache-size") != std::string::npos), false);
+    TEST_OPTION((hidden.find("--an-unreasonably") != std::string::npos), true);
+    TEST_OPTION((basic.size() < hidden.size() / 2), true);
+    TEST_OPTION((parser.getHelp(cmdlp::HelpTier::advanced).find("--cache-size") != std::string::npos), true);
+
+    // The options added to a section later on are shown in its tier.
+    parser.addToggle("", "--disk.sync", "Sync the disk cache on write", false);
+    cmdlp::Fragment disk;
+    disk.addOption("", "--disk.quota", "Disk quota", 100, false);
+    parser.merge(disk);
+    basic = parser.getHelp();
+    TEST_OPTION((basic.find("--disk.sync") != std::string::npos), false);
+    TEST_OPTION((basic.find("--disk.quota") != std::string::npos), false);
+    TEST_OPTION((parser.getHelp(cmdlp::HelpTier::advanced).find("--disk.quota") != std::string::npos), true);
+    return 0;
+}
+
+/// @brief Checks that values are converted and validated through `value_traits`.
+static int test_value_traits()
+{
+    std::vector<const char *> arguments = { "test_cmdlp", "--gain", "2.250", "--count", "12abc" };
+
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.addOption("-g", "--gain", "Fixed-point gain", Fixed{ 1500 }, false);
+    parser.addOption("-c", "--count", "A count", 3, false);
+    TEST_OPTION(parser.getOption<std::string>("--gain"), "1.500");
+    bool rejected = false;
+    try {
+        parser.parseOptions();
+    } catch (const std::invalid_argument &) {
+        rejected = true;
+    }
+    // A failed parse modifies no option, not even the ones with a valid value.
+    TEST_OPTION(rejected, true);
+    TEST_OPTION(parser.getOption<Fixed>("--gain").milli, 1500);
+    TEST_OPTION(parser.getOption<int>("--count"), 3);
+
+    // Reading a value as a type it cannot be converted to is an error.
+    parser.addOption("-n", "--name", "A name", std::string("node"), false);
+    bool unconverted = false;
+    try {
+        parser.getOption<int>("--name");
+    } catch (const std::invalid_argument &) {
+        unconverted = true;
+    }
+    TEST_OPTION(unconverted, true);
+
+    // Floating-point values use the "C" locale, even under a decimal-comma one, if installed.
+    const char *comma_locales[] = { "de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "fr_FR.utf8", "it_IT.UTF-8", "it_IT.utf8" };
+    for (const char *name : comma_locales) {
+        if (std::setlocale(LC_ALL, name)) {
+            break;
+        }
+    }
+    arguments = { "test_cmdlp", "--ratio", "+0.5" };
+    cmdlp::Parser ratios(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    ratios.addOption("-r", "--ratio", "A ratio", 0.25, false);
+    std::string ratio_default = ratios.getOption<std::string>("--ratio");
+    ratios.parseOptions();
+    double ratio = ratios.getOption<double>("--ratio");
+    std::setlocale(LC_ALL, "C");
+    TEST_OPTION(ratio_default, "0.25");
+    TEST_OPTION(ratio, 0.5);
+    TEST_OPTION(cmdlp::detail::format_value(1234567.0), "1.23457e+06");
+    return 0;
+}
+
+/// @brief Checks that repeated tuple options are split and converted while parsing.
+static int test_tuples()
+{
+    std::vector<const char *> arguments = { "test_cmdlp", "--endpoint", "10.0.0.1:9000:3", "-e", "backup:9001:1" };
+
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.addTupleOption<std::string, unsigned short, int>("-e", "--endpoint", "Endpoint as host:port:weight", ':');
+    parser.parseOptions();
+
+    const auto &endpoints = parser.getTuples<std::string, unsigned short, int>("--endpoint");
+    TEST_OPTION(endpoints.size(), 2U);
+    TEST_OPTION(std::get<0>(endpoints[0]), "10.0.0.1");
+    TEST_OPTION(std::get<1>(endpoints[1]), 9001);
+    TEST_OPTION(std::get<2>(endpoints[0]), 3);
+    TEST_OPTION(parser.getOption<std::string>("--endpoint"), "10.0.0.1:9000:3, backup:9001:1");
+
+    // Invalid elements are rejected while parsing.
+    arguments = { "test_cmdlp", "--endpoint", "host:99999:1" };
+    parser.setArguments(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    bool rejected = false;
+    try {
+        parser.parseOptions();
+    } catch (const std::invalid_argument &) {
+        rejected = true;
+    }
+    TEST_OPTION(rejected, true);
+    return 0;
+}
+
+/// @brief Checks that network addresses are converted while parsing and matched against an allow-list.
+static int test_addresses()
+{
+    std::vector<const char *> arguments = { "test_cmdlp", "--bind", "[2001:DB8:0:0:1::1]:8080", "--allow", "10.1.2.3/8",
+                                            "--allow", "2001:db8::/32", "--allow", "192.168.1.7" };
+
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.addOption("-b", "--bind", "Address to listen on", cmdlp::net::Endpoint{}, false);
+    parser.addTupleOption<cmdlp::net::Prefix>("-a", "--allow", "Allowed clients", ',');
+    parser.parseOptions();
+
+    cmdlp::net::Endpoint bind = parser.getOption<cmdlp::net::Endpoint>("--bind");
+    TEST_OPTION((bind.port), 8080);
+    TEST_OPTION((bind.address.family == cmdlp::net::Address::Family::ipv6), true);
+    TEST_OPTION(cmdlp::detail::format_value(bind), "[2001:db8::1:0:0:1]:8080");
+    TEST_OPTION(parser.getOption<std::string>("--allow"), "10.1.2.3/8, 2001:db8::/32, 192.168.1.7/32");
+
+    cmdlp::net::PrefixTable allowed(parser.getTuples<cmdlp::net::Prefix>("--allow"));
+    cmdlp::net::Address address;
+    for (const char *text : { "10.255.0.1", "192.168.1.7", "2001:db8:ffff::1", "::ffff:10.0.0.1" }) {
+        TEST_OPTION((cmdlp::value_traits<cmdlp::net::Address>::parse(text, address)), true);
+        TEST_OPTION((allowed.contains(address)), (std::string_view(text) != "::ffff:10.0.0.1"));
+    }
+    for (const char *text : { "11.0.0.1", "192.168.1.8", "2001:db9::1" }) {
+        cmdlp::value_traits<cmdlp::net::Address>::parse(text, address);
+        TEST_OPTION((allowed.contains(address)), false);
+    }
+    TEST_OPTION(cmdlp::detail::format_value(address), "2001:db9::1");
+
+    // Malformed addresses are rejected while parsing.
+    for (const char *text : { "256.0.0.1", "1.2.3", "1:2:3:4:5:6:7:8:9", "1::2::3", "10.0.0.0/33", ":1", "1:",
+                              "1:2:3:4:5:6:7:8::", "::1:2:3:4:5:6:7:8", "1:2:3:4::5:6:7:8" }) {
+        TEST_OPTION((cmdlp::detail::validate_value<cmdlp::net::Prefix>(text)), false);
+    }
+    // A "::" may stand for a single group.
+    TEST_OPTION((cmdlp::value_traits<cmdlp::net::Address>::parse("1:2:3:4:5:6:7::", address)), true);
+    TEST_OPTION(cmdlp::detail::format_value(address), "1:2:3:4:5:6:7:0");
+    arguments = { "test_cmdlp", "--bind", "::1:80" };
+    parser.setArguments(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    bool rejected = false;
+    try {
+        parser.parseOptions();
+    } catch (const std::invalid_argument &) {
+        rejected = true;
+    }
+    TEST_OPTION(rejected, true);
+    return 0;
+}
+
+/// @brief Checks that allowed values listed in a file are only read when a value is selected.
+static int test_value_files()
+{
+    const std::string path = "test_cmdlp_models.txt";
+    {
+        std::ofstream file(path);
+        file << "resnet50\r\nbert-base\n\nbert-large\nresnet101\nbert-base\n";
+    }
+    std::vector<const char *> arguments = { "test_cmdlp" };
+
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.addMultiOptionFromFile("-m", "--model", "Model to load", path, "resnet50");
+    parser.parseOptions();
+    TEST_OPTION(parser.getOption<std::string>("--model"), "resnet50");
+
+    // The file is removed before any value is selected, so it was never read.
+    std::remove(path.c_str());
+    bool failed = false;
+    try {
+        parser.completeValue("--model", "bert");
+    } catch (const std::runtime_error &) {
+        failed = true;
+    }
+    TEST_OPTION(failed, true);
+
+    // Profiles are checked against the file when they are selected, not when added.
+    parser.addProfileOption("-p", "--profile", "Profile");
+    parser.addProfile("vision", { { "--model", "resnet101" } });
+    parser.addProfile("typo", { { "-m", "bert-lage" } });
+
+    {
+        std::ofstream file(path);
+        file << "resnet50\r\nbert-base\n\nbert-large\nresnet101\nbert-base\n";
+    }
+    arguments = { "test_cmdlp", "--model", "bert-large" };
+    parser.setArguments(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.parseOptions();
+    std::remove(path.c_str());
+    TEST_OPTION(parser.getOption<std::string>("--model"), "bert-large");
+    std::vector<std::string> completions = parser.completeValue("--model", "res");
+    TEST_OPTION(completions.size(), 2U);
+    TEST_OPTION(completions[0], "resnet101");
+    TEST_OPTION(completions[1], "resnet50");
+    TEST_OPTION(parser.completeValue("--model", "").size(), 4U);
+
+    arguments = { "test_cmdlp", "--model", "bert" };
+    parser.setArguments(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    bool rejected = false;
+    try {
+        parser.parseOptions();
+    } catch (const std::invalid_argument &) {
+        rejected = true;
+    }
+    TEST_OPTION(rejected, true);
+
+    arguments = { "test_cmdlp", "--profile", "typo" };
+    parser.setArguments(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    std::string message;
+    try {
+        parser.parseOptions();
+    } catch (const std::invalid_argument &error) {
+        message = error.what();
+    }
+    TEST_OPTION((message.find("Profile \"typo\" sets --model to \"bert-lage\", which is not in the list of allowed values") == 0), true);
+    arguments = { "test_cmdlp", "--profile", "vision" };
+    parser.setArguments(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.parseOptions();
+    TEST_OPTION(parser.getOption<std::string>("--model"), "resnet101");
+
+    // Copies parsed on different threads share the file, and load it once.
+    {
+        std::ofstream file(path);
+        file << "resnet50\nbert-base\nbert-large\n";
+    }
+    arguments = { "test_cmdlp" };
+    cmdlp::Parser schema(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    schema.addMultiOptionFromFile("-m", "--model", "Model to load", path, "resnet50");
+    cmdlp::ParseCache cache(8);
+    std::vector<std::vector<const char *>> invocations = {
+        { "test_cmdlp", "--model", "bert-base" },
+        { "test_cmdlp", "--model", "bert-large" },
+        { "test_cmdlp", "-m", "bert-base" },
+        { "test_cmdlp", "-m", "bert-large" },
+    };
+    std::vector<std::string> selected(invocations.size());
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < invocations.size(); ++i) {
+        workers.emplace_back([&, i]() {
+            std::vector<const char *> &argv = invocations[i];
+            selected[i] = cache.parse(schema, static_cast<int>(argv.size()), const_cast<char **>(argv.data()))->getOption<std::string>("--model");
+        });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    std::remove(path.c_str());
+    for (std::size_t i = 0; i < invocations.size(); ++i) {
+        TEST_OPTION(selected[i], invocations[i][2]);
+    }
+    return 0;
+}
+
+/// @brief The state shared with the signal handler of `test_signal_safe`.
+static struct {
+    const cmdlp::Parser *parser;
+    cmdlp::SignalSafeHandle dump_dir, level, verbose;
+    char text[64];
+    long long integer;
+    bool toggled, converted;
+} signal_state;
+
+/// @brief Reads the options from inside a signal handler.
+static void read_options_in_handler(int)
+{
+    signal_state.parser->readSignalSafe(signal_state.dump_dir, signal_state.text, sizeof(signal_state.text));
+    signal_state.converted = signal_state.parser->readSignalSafe(signal_state.level, signal_state.integer) &&
+                             signal_state.parser->readSignalSafe(signal_state.verbose, signal_state.toggled);
+}
+
+/// @brief Checks that the signal-safe readers work from inside a signal handler.
+static int test_signal_safe()
+{
+#ifdef SIGUSR1
+    const int signal_number = SIGUSR1;
+#else
+    const int signal_number = SIGTERM;
+#endif
+    std::vector<const char *> arguments = { "test_cmdlp", "--dump-dir", "/var/crash/service", "--verbose" };
+
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.addOption("-d", "--dump-dir", "Where to write dumps", std::string("/tmp"), false);
+    parser.addOption("-l", "--level", "Log level", 2, false);
+    parser.addToggle("-v", "--verbose", "Verbose dumps", false);
+    signal_state.parser   = &parser;
+    signal_state.dump_dir = parser.addSignalSafe("--dump-dir");
+    signal_state.level    = parser.addSignalSafe("-l");
+    signal_state.verbose  = parser.addSignalSafe("--verbose");
+    std::signal(signal_number, read_options_in_handler);
+
+    // Before parsing, the handler sees the defaults.
+    std::raise(signal_number);
+    TEST_OPTION(std::string(signal_state.text), "/tmp");
+    TEST_OPTION((signal_state.converted && (signal_state.integer == 2) && !signal_state.toggled), true);
+
+    parser.parseOptions();
+    std::raise(signal_number);
+    TEST_OPTION(std::string(signal_state.text), "/var/crash/service");
+    TEST_OPTION((signal_state.converted && (signal_state.integer == 2) && signal_state.toggled), true);
+
+    // A value longer than the buffer is truncated, and the full length returned.
+    char small[5];
+    TEST_OPTION(parser.readSignalSafe(signal_state.dump_dir, small, sizeof(small)), 18U);
+    TEST_OPTION(std::string(small), "/var");
+    std::signal(signal_number, SIG_DFL);
+    return 0;
+}
+
+/// @brief A source holding fixed settings, slow to load, to check that the merge ignores the completion order.
+class SlowSource : public cmdlp::ConfigSource {
+public:
+    explicit SlowSource(std::vector<Setting> _settings)
+        : settings(std::move(_settings))
+    {
+    }
+
+    virtual std::string name() const override
+    {
+        return "slow source";
+    }
+
+    virtual void load(const cmdlp::detail::OptionList &, std::vector<Setting> &result) const override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        result = settings;
+    }
+
+private:
+    std::vector<Setting> settings;
+};
+
+/// @brief Checks that configuration sources are loaded and merged by precedence before the command line.
+static int test_sources()
+{
+    const std::string path = "test_cmdlp_sources.conf";
+    {
+        std::ofstream file(path);
+        file << "# User configuration\n--level = 3\n\nname = user\r\n";
+    }
+    std::vector<const char *> arguments = { "test_cmdlp", "--name", "cli" };
+
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.addOption("-l", "--level", "Log level", 1, false);
+    parser.addOption("-n", "--name", "Service name", std::string("default"), false);
+    parser.addOption("-k", "--key", "Secret key", std::string(), true);
+    parser.addToggle("-v", "--verbose", "Verbose output", false);
+    parser.addSource(std::make_shared<SlowSource>(std::vector<cmdlp::ConfigSource::Setting>{ { "--level", "2" }, { "--verbose", "true" } }));
+    parser.addSource(std::make_shared<cmdlp::FileSource>(path));
+    parser.addSource(std::make_shared<cmdlp::FileSource>("test_cmdlp_missing.conf"));
+    parser.addSource(std::make_shared<SlowSource>(std::vector<cmdlp::ConfigSource::Setting>{ { "--key", "secret" } }));
+    parser.parseOptions();
+
+    // The file finishes first, but overrides the slow source declared before it.
+    TEST_OPTION(parser.getOption<int>("--level"), 3);
+    TEST_OPTION(parser.getOption<bool>("--verbose"), true);
+    TEST_OPTION(parser.getOption<std::string>("--name"), "cli");
+    TEST_OPTION(parser.getOption<std::string>("--key"), "secret");
+
+    // A failed reload keeps all the values loaded before, not part of the new ones.
+    {
+        std::ofstream file(path);
+        file << "level = 5\nzzz = 3\nverbose = false\n";
+    }
+    bool rejected = false;
+    try {
+        parser.loadSources();
+    } catch (const std::invalid_argument &) {
+        rejected = true;
+    }
+    std::remove(path.c_str());
+    parser.parseOptions();
+    TEST_OPTION(rejected, true);
+    TEST_OPTION(parser.getOption<int>("--level"), 3);
+    TEST_OPTION(parser.getOption<bool>("--verbose"), true);
+
+    // Unknown options and invalid values are reported with their source.
+    rejected = false;
+    parser.addSource(std::make_shared<SlowSource>(std::vector<cmdlp::ConfigSource::Setting>{ { "--unknown", "1" } }));
+    try {
+        parser.loadSources();
+    } catch (const std::invalid_argument &) {
+        rejected = true;
+    }
+    TEST_OPTION(rejected, true);
+    cmdlp::Parser strict(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    strict.addOption("-l", "--level", "Log level", 1, false);
+    strict.addSource(std::make_shared<SlowSource>(std::vector<cmdlp::ConfigSource::Setting>{ { "--level", "high" } }));
+    rejected = false;
+    try {
+        strict.parseOptions();
+    } catch (const std::invalid_argument &) {
+        rejected = true;
+    }
+    TEST_OPTION(rejected, true);
+    return 0;
+}
+
+/// @brief Checks that a JSON source reads only the keys of the registered options.
+static int test_json_source()
+{
+    const std::string path = "test_cmdlp_config.json";
+    {
+        std::ofstream file(path);
+        file << R"({
+  "other-tool": { "threshold": [1, {"a": "}]\"{"}, [[]]], "note": "skip \\\" me" },
+  "db": { "pool": { "size": 16, "unused": null }, "host": "dbé.local \"main\"" },
+  "db.timeout": 2.5,
+  "verbose": true,
+  "retries": null,
+  "endpoint": ["a:1", "b:2"]
+})";
+    }
+    std::vector<const char *> arguments = { "test_cmdlp" };
+
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.addOption("-d", "--db", "Database name", std::string("main"), false);
+    parser.addOption("-s", "--db.pool.size", "Pool size", 4, false);
+    parser.addOption("-H", "--db.host", "Database host", std::string("localhost"), false);
+    parser.addOption("-t", "--db.timeout", "Timeout", 1.0, false);
+    parser.addOption("-r", "--retries", "Retries", 3, false);
+    parser.addToggle("-v", "--verbose", "Verbose output", false);
+    parser.addTupleOption<std::string, int>("-e", "--endpoint", "Endpoint as host:port", ':');
+    parser.addSource(std::make_shared<cmdlp::JsonSource>(path));
+    parser.parseOptions();
+
+    TEST_OPTION(parser.getOption<std::string>("--db"), "main");
+    TEST_OPTION(parser.getOption<int>("--db.pool.size"), 16);
+    TEST_OPTION(parser.getOption<std::string>("--db.host"), "db\xc3\xa9.local \"main\"");
+    TEST_OPTION(parser.getOption<double>("--db.timeout"), 2.5);
+    TEST_OPTION(parser.getOption<int>("--retries"), 3);
+    TEST_OPTION(parser.getOption<bool>("--verbose"), true);
+    TEST_OPTION((parser.getTuples<std::string, int>("--endpoint").size()), 2U);
+
+    // A malformed document is reported, even outside the selected keys.
+    auto load_error = [&](const char *document) {
+        {
+            std::ofstream file(path);
+            file << document;
+        }
+        try {
+            parser.loadSources();
+        } catch (const std::invalid_argument &error) {
+            return std::string(error.what());
+        }
+        return std::string();
+    };
+    // A key that is both an option and an object holding options takes a scalar too.
+    TEST_OPTION(load_error(R"({ "db": "replica", "db.host": "h" })"), "");
+    parser.parseOptions();
+    TEST_OPTION(parser.getOption<std::string>("--db"), "replica");
+    TEST_OPTION(parser.getOption<std::string>("--db.host"), "h");
+
+    const std::string unbalanced  = load_error(R"({ "other": [1, 2, "db": 3 })");
+    const std::string mismatched  = load_error(R"({ "other": {"a":[} ] })");
+    const std::string unsupported = load_error(R"({ "db": { "pool": { "size": { "min": 1 } } } })");
+    std::remove(path.c_str());
+    TEST_OPTION((unbalanced.find("malformed JSON") != std::string::npos), true);
+    TEST_OPTION((mismatched.find("malformed JSON") != std::string::npos), true);
+    TEST_OPTION((unsupported.find("unsupported value type for key \"db.pool.size\"") != std::string::npos), true);
+    return 0;
+}
+
+static int test_effective_config()
+{
+    const std::string path = "test_cmdlp_effective.conf";
+    {
+        std::ofstream file(path);
+        file << "threads = 8\n";
+    }
+    std::vector<const char *> arguments = { "test_cmdlp", "--name", "a \"quoted\" name", "-v" };
+
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.addOption("-t", "--threads", "Worker threads", 4, false);
+    parser.addOption("-n", "--name", "Service name", std::string("service"), false);
+    parser.addOption("-p", "--port", "Port", 80, false);
+    parser.addToggle("-v", "--verbose", "Verbose output", false);
+    parser.addSource(std::make_shared<cmdlp::FileSource>(path));
+    parser.parseOptions();
+    std::remove(path.c_str());
+
+    TEST_OPTION((parser.getOrigin("--threads") == cmdlp::ValueOrigin::source), true);
+    TEST_OPTION((parser.getOrigin("--name") == cmdlp::ValueOrigin::command_line), true);
+    TEST_OPTION((parser.getOrigin("-p") == cmdlp::ValueOrigin::default_value), true);
+
+    std::stringstream lines;
+    parser.writeEffectiveConfig(lines, true);
+    TEST_OPTION(lines.str(), "threads = 8\nname    = a \"quoted\" name\nverbose = true\n");
+
+    std::stringstream json;
+    parser.writeEffectiveConfig(json, false, cmdlp::ConfigFormat::json);
+    TEST_OPTION(json.str(), "{\n  \"threads\": \"8\",\n  \"name\": \"a \\\"quoted\\\" name\",\n  \"port\": \"80\",\n  \"verbose\": true\n}\n");
+
+    // The output is read back as it is by the sources.
+    {
+        std::ofstream file(path);
+        file << lines.str();
+    }
+    std::vector<const char *> none = { "test_cmdlp" };
+    cmdlp::Parser copy(static_cast<int>(none.size()), const_cast<char **>(none.data()));
+    copy.addOption("-t", "--threads", "Worker threads", 4, false);
+    copy.addOption("-n", "--name", "Service name", std::string("service"), false);
+    copy.addOption("-p", "--port", "Port", 80, false);
+    copy.addToggle("-v", "--verbose", "Verbose output", false);
+    copy.addSource(std::make_shared<cmdlp::FileSource>(path));
+    copy.parseOptions();
+    std::remove(path.c_str());
+    TEST_OPTION(copy.getOption<int>("--threads"), 8);
+    TEST_OPTION(copy.getOption<std::string>("--name"), "a \"quoted\" name");
+    TEST_OPTION(copy.getOption<bool>("--verbose"), true);
+    return 0;
+}
+
+static int test_string_views()
+{
+    std::vector<const char *> arguments = { "test_cmdlp", "--output-dir", "/var/lib/service/records/output", "-v" };
+
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.addOption("-o", "--output-dir", "Output directory", std::string("."), false);
+    parser.addOption("-b", "--batch", "Records per batch", 64, false);
+    parser.addOption("-i", "--index", "Index file", std::string(""), false);
+    parser.addToggle("-v", "--verbose", "Verbose output", false);
+    parser.addLiveOption<int>("-l", "--log-level", "Log level", 2);
+    parser.addDerivation("--index", { "--output-dir" }, [](const cmdlp::Parser &p) { return p.getOption<std::string>("--output-dir") + "/index"; });
+    parser.parseOptions();
+
+    // Views point into the options, so repeated reads do not copy.
+    std::string_view output = parser.getOptionView("--output-dir");
+    TEST_OPTION(output, "/var/lib/service/records/output");
+    TEST_OPTION((parser.getOptionView("-o").data() == output.data()), true);
+    TEST_OPTION(parser.getOptionView("--verbose"), "true");
+    TEST_OPTION(parser.getOptionView("--index"), "/var/lib/service/records/output/index");
+    TEST_OPTION(parser.getOptionView("--unknown").empty(), true);
+
+    cmdlp::Handle<std::string> output_handle = parser.getHandle<std::string>("--output-dir");
+    cmdlp::Handle<int> batch_handle          = parser.getHandle<int>("-b");
+    TEST_OPTION((output_handle.get().data() == output.data()), true);
+    TEST_OPTION(batch_handle.get(), 64);
+
+    // Live options format their value on demand, so they cannot be viewed.
+    bool rejected = false;
+    try {
+        parser.getHandle<std::string>("--log-level");
+    } catch (const std::invalid_argument &) {
+        rejected = true;
+    }
+    TEST_OPTION(rejected, true);
+    TEST_OPTION(parser.getHandle<int>("--log-level").get(), 2);
+    return 0;
+}
+
+static int test_live_origins()
+{
+    std::vector<const char *> arguments = { "test_cmdlp", "--sampling", "0.25" };
+
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.addLiveOption("-l", "--log-level", "Log level", 2);
+    parser.addLiveOption("-s", "--sampling", "Sampling rate", 0.5);
+    parser.parseOptions();
+    TEST_OPTION((parser.getOrigin("--log-level") == cmdlp::ValueOrigin::default_value), true);
+    cmdlp::SignalSafeHandle level = parser.addSignalSafe("--log-level");
+
+    parser.setLiveValue("--log-level", "4");
+    parser.setLiveValue("--sampling", "0.75");
+    TEST_OPTION((parser.getOrigin("--log-level") == cmdlp::ValueOrigin::runtime), true);
+    // Signal handlers see the runtime value.
+    long long published = 0;
+    TEST_OPTION(parser.readSignalSafe(level, published), true);
+    TEST_OPTION(published, 4LL);
+
+    // Parsing again keeps the runtime values, unless the arguments set them again.
+    parser.parseOptions();
+    TEST_OPTION(parser.getLive<int>("--log-level").load(), 4);
+    TEST_OPTION((parser.getOrigin("--log-level") == cmdlp::ValueOrigin::runtime), true);
+    TEST_OPTION(parser.getLive<double>("--sampling").load(), 0.25);
+    TEST_OPTION((parser.getOrigin("--sampling") == cmdlp::ValueOrigin::command_line), true);
+
+    std::stringstream lines;
+    parser.writeEffectiveConfig(lines, true);
+    TEST_OPTION(lines.str(), "log-level = 4\nsampling  = 0.25\n");
+    return 0;
+}
+
+/// @brief Maps all the arguments to the same key, to exercise the collisions.
+static uint64_t colliding_hash(uint64_t fingerprint, int, char **)
+{
+    return fingerprint;
+}
+
+static int test_parse_cache()
+{
+    std::vector<const char *> arguments = { "test_cmdlp" };
+
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.addOption("-t", "--threads", "Worker threads", 4, false);
+    parser.addOption("-l", "--lanes", "Lanes", 0, false);
+    parser.addDerivation("--lanes", { "--threads" }, [](const cmdlp::Parser &p) { return 2 * p.getOption<int>("--threads"); });
+    std::size_t notified = 0;
+    parser.subscribe("--threads", [&](const std::vector<std::size_t> &) { ++notified; });
+
+    std::vector<const char *> a = { "test_cmdlp", "-t", "1" };
+    std::vector<const char *> b = { "test_cmdlp", "-t", "2" };
+    std::vector<const char *> c = { "test_cmdlp", "-t", "3" };
+    auto parse                  = [&](cmdlp::ParseCache &cache, std::vector<const char *> &argv) {
+        return cache.parse(parser, static_cast<int>(argv.size()), const_cast<char **>(argv.data()));
+    };
+
+    // Hits and misses, with the derived options computed before publishing.
+    cmdlp::ParseCache cache(2);
+    cmdlp::ParseCache::result_t first = parse(cache, a);
+    TEST_OPTION((parse(cache, a) == first), true);
+    TEST_OPTION(cache.getHits(), 1U);
+    TEST_OPTION(cache.getMisses(), 1U);
+    TEST_OPTION(first->getOption<int>("--lanes"), 2);
+    TEST_OPTION((first->getOrigin("--lanes") == cmdlp::ValueOrigin::derived), true);
+    // The observers of the schema are not run by the copies.
+    TEST_OPTION(notified, 0U);
+
+    // The least recently used result is evicted at capacity.
+    parse(cache, b);
+    parse(cache, a);
+    parse(cache, c);
+    TEST_OPTION(cache.size(), 2U);
+    TEST_OPTION(cache.getHits(), 2U);
+    parse(cache, a);
+    TEST_OPTION(cache.getHits(), 3U);
+    parse(cache, b);
+    TEST_OPTION(cache.getMisses(), 4U);
+
+    // Arguments sharing a key are told apart.
+    cmdlp::ParseCache colliding(4, &colliding_hash);
+    TEST_OPTION(parse(colliding, a)->getOption<int>("--threads"), 1);
+    TEST_OPTION(parse(colliding, b)->getOption<int>("--threads"), 2);
+    TEST_OPTION(parse(colliding, a)->getOption<int>("--threads"), 1);
+    TEST_OPTION(colliding.getHits(), 0U);
+    TEST_OPTION(colliding.getMisses(), 3U);
+
+    // Changing the schema invalidates the results parsed against it.
+    parser.addToggle("-v", "--verbose", "Verbose output", false);
+    TEST_OPTION((parse(cache, a) == first), false);
+    TEST_OPTION(cache.getMisses(), 5U);
+    TEST_OPTION(parse(cache, a)->getOption<bool>("--verbose"), false);
+    TEST_OPTION(cache.getHits(), 4U);
+
+    // Parsing the schema itself changes its values, but not the results.
+    std::vector<const char *> d = { "test_cmdlp", "-t", "7", "-v" };
+    parser.setArguments(static_cast<int>(d.size()), const_cast<char **>(d.data()));
+    parser.parseOptions();
+    TEST_OPTION(parse(cache, a)->getOption<int>("--threads"), 1);
+    TEST_OPTION(cache.getHits(), 5U);
+
+    // Loading the sources again invalidates the results parsed with the old values.
+    const std::string path = "test_cmdlp_cache.conf";
+    {
+        std::ofstream file(path);
+        file << "lanes = 1\n";
+    }
+    parser.addSource(std::make_shared<cmdlp::FileSource>(path));
+    parser.loadSources();
+    TEST_OPTION(parse(cache, b)->getOption<int>("--lanes"), 1);
+    {
+        std::ofstream file(path);
+        file << "lanes = 5\n";
+    }
+    parser.loadSources();
+    std::remove(path.c_str());
+    TEST_OPTION(parse(cache, b)->getOption<int>("--lanes"), 5);
+    return 0;
+}
+
+/// @brief A sink recording the events as "B name", "E name" and "C name=value".
+class RecordingSink : public cmdlp::TraceSink {
+public:
+    std::vector<std::string> events;
+
+    void begin(const char *name) override
+    {
+        events.push_back(std::string("B ") + name);
+    }
+
+    void end(const char *name) override
+    {
+        events.push_back(std::string("E ") + name);
+    }
+
+    void counter(const char *name, std::size_t value) override
+    {
+        events.push_back(std::string("C ") + name + "=" + std::to_string(value));
+    }
+};
+
+/// @brief Tells whether the begin and end events of a recording are properly nested.
+static bool is_nested(const std::vector<std::string> &events)
+{
+    std::vector<std::string> open;
+    for (const std::string &event : events) {
+        if (event[0] == 'B') {
+            open.push_back(event.substr(2));
+        } else if (event[0] == 'E') {
+            if (open.empty() || (open.back() != event.substr(2))) {
+                return false;
+            }
+            open.pop_back();
+        }
+    }
+    return open.empty();
+}
+
+/// @brief Registers, parses and prints the help of a few options, tracing into a Chrome trace file.
+/// @return The content of the trace file, read back once the sink is closed.
+static std::string write_chrome_trace(int argc, char **argv)
+{
+    const std::string path = "test_cmdlp_trace.json";
+    {
+        cmdlp::ChromeTraceSink chrome(path);
+        cmdlp::Parser parser(argc, argv, &chrome);
+        parser.addOption("-t", "--threads", "Worker threads", 4, false);
+        parser.parseOptions();
+        parser.getHelp();
+    }
+    std::ifstream file(path);
+    const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::remove(path.c_str());
+    return text;
+}
+
+static int test_tracing()
+{
+    std::vector<const char *> arguments = { "test_cmdlp", "--threads", "2" };
+    const int argc = static_cast<int>(arguments.size());
+    char **argv    = const_cast<char **>(arguments.data());
+
+    RecordingSink sink;
+    cmdlp::Parser parser(argc, argv, &sink);
+    for (int i = 0; i < 100; ++i) {
+        parser.addOption("", "--option-" + std::to_string(i), "An option", i, false);
+    }
+    parser.addOption("-t", "--threads", "Worker threads", 4, false);
+    parser.parseOptions();
+    parser.getHelp();
+    // A second burst of registrations is a second phase, with its own counter.
+    parser.addToggle("-v", "--verbose", "Verbose output", false);
+    parser.parseOptions();
+    const std::vector<std::string> expected = {
+        "B tokenize", "C tokens=2", "E tokenize",
+        "B register", "C options=101", "E register",
+        "B parse", "C matched=1", "E parse",
+        "B help", "E help",
+        "B register", "C options=102", "E register",
+        "B parse", "C matched=1", "E parse",
+    };
+    const std::vector<std::string> events = sink.events;
+    TEST_OPTION((events == expected), true);
+    TEST_OPTION(is_nested(events), true);
+
+    // The results of a cache, which may be parsed on several threads, do not trace.
+    cmdlp::ParseCache cache(1);
+    TEST_OPTION(cache.parse(parser, argc, argv)->getOption<int>("--threads"), 2);
+    TEST_OPTION(sink.events.size(), expected.size());
+
+    // The Chrome trace is a closed JSON array of event objects.
+    const std::string text = write_chrome_trace(argc, argv);
+    int depth = 0, objects = 0;
+    bool balanced = true, in_string = false;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (in_string) {
+            in_string = (c != '"') || (text[i - 1] == '\\');
+        } else if (c == '"') {
+            in_string = true;
+        } else if ((c == '[') || (c == '{')) {
+            objects += (c == '{') && (depth == 1);
+            ++depth;
+        } else if ((c == ']') || (c == '}')) {
+            balanced = balanced && (--depth >= 0);
+        }
+    }
+    TEST_OPTION(text.front(), '[');
+    TEST_OPTION(text.substr(text.size() - 2), "]\n");
+    TEST_OPTION((balanced && (depth == 0) && !in_string), true);
+    TEST_OPTION((text.find(",\n]") == std::string::npos), true);
+    TEST_OPTION((objects > 0), true);
+    return 0;
+}
+
+/// @brief A stream buffer holding only the head of the input, as a pipe whose writer is still running.
+class HeadBuffer : public std::streambuf {
+public:
+    explicit HeadBuffer(std::string _head)
+        : head(std::move(_head)),
+          starved(false)
+    {
+        this->setg(&head[0], &head[0], &head[0] + head.size());
+    }
+
+    /// @brief Tells whether a read went past the head.
+    bool isStarved() const
+    {
+        return starved;
+    }
+
+protected:
+    virtual int_type underflow() override
+    {
+        starved = true;
+        return traits_type::eof();
+    }
+
+private:
+    std::string head;
+    bool starved;
+};
+
+/// @brief Checks that events are produced before the end of the stream, with a bounded buffer.
+static int test_stream_events()
+{
+    std::vector<const char *> arguments = { "test_cmdlp" };
+
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.addOption("-i", "--int", "An integer value", -1, false);
+    parser.addToggle("-v", "--verbose", "Enables verbose output", false);
+
+    // The first event only needs the tokens of the first option.
+    HeadBuffer head("--int 7 ");
+    std::istream pipe(&head);
+    cmdlp::EventCursor first = parser.streamEvents(pipe);
+    cmdlp::ParseEvent event;
+    TEST_OPTION(first.next(event), true);
+    TEST_OPTION(event.value, "7");
+    TEST_OPTION(head.isStarved(), false);
+
+    // The buffer depends on the longest token, not on the number of tokens.
+    std::string text;
+    for (std::size_t i = 0; i < 20000; ++i) {
+        text += "--int " + std::to_string(i) + " -v input-" + std::to_string(i) + "\n";
+    }
+    std::istringstream stream(text);
+    cmdlp::EventCursor cursor = parser.streamEvents(stream);
+    std::size_t events = 0, largest = 0;
+    while (cursor.next(event)) {
+        ++events;
+        largest = std::max(largest, cursor.getBufferSize());
+    }
+    TEST_OPTION(events, 60000U);
+    TEST_OPTION((largest <= 2 * std::string("input-19999").capacity()), true);
+    return 0;
+}
+
 int main(int, char *[])
 {
+    if (test_profiles() || test_derivations() || test_observers() || test_namespaces() || test_fragments() ||
+        test_help_sections() || test_value_traits() || test_tuples() || test_addresses() ||
+        test_value_files() || test_signal_safe() || test_sources() ||
+        test_json_source() || test_effective_config() || test_string_views() ||
+        test_live_origins() || test_parse_cache() || test_tracing() ||
+        test_stream_events()) {
+        return 1;
+    }
+
     std::vector<const char *> arguments = {
         "test_cmdlp",
         "--double",
@@ -20,6 +1148,7 @@ int main(int, char *[])
         "-s",
         "Hello",
         "--verbose",
+        "input.txt",
     };
 
     cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
@@ -37,5 +1166,22 @@ int main(int, char *[])
     TEST_OPTION(parser.getOption<std::string>("-s"), "Hello");
     TEST_OPTION(parser.getOption<bool>("-v"), true);
 
+    // Walk the arguments without storing the values.
+    std::size_t num_options = 0, num_positionals = 0;
+    parser.parseEvents([&](const cmdlp::ParseEvent &event) {
+        (event.isPositional() ? num_positionals : num_options) += 1;
+    });
+    TEST_OPTION(num_options, 5U);
+    TEST_OPTION(num_positionals, 1U);
+
+    // Pull the events from a stream, one at a time.
+    std::istringstream stream("--int 7 'first input' -v second");
+    cmdlp::EventCursor cursor = parser.streamEvents(stream);
+    cmdlp::ParseEvent event;
+    TEST_OPTION(cursor.next(event), true);
+    TEST_OPTION(event.value, "7");
+    TEST_OPTION(cursor.next(event), true);
+    TEST_OPTION(event.value, "first input");
+
     return 0;
 }
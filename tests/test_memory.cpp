@@ -0,0 +1,39 @@
+#include "cmdlp/parser.hpp"
+
+/// @brief The largest footprint accepted for each registered option, in bytes.
+/// @details Lower it as the layout of the options gets more compact.
+#define BYTES_PER_OPTION_BUDGET 480
+
+int main(int, char *[])
+{
+    const std::size_t num_options = 1000;
+
+    std::vector<const char *> arguments = { "test_memory", "--option-number-1", "42" };
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    for (std::size_t i = 0; i < num_options; ++i) {
+        if (i % 100 == 0) {
+            parser.addSeparator("Options from " + std::to_string(i) + ":");
+        }
+        parser.addOption("-o" + std::to_string(i), "--option-number-" + std::to_string(i), "A typical description for an option", 0, false);
+    }
+    parser.parseOptions();
+
+    cmdlp::detail::MemoryUsage usage = parser.memoryUsage();
+    std::cout << "Memory usage for " << num_options << " options:\n"
+              << "    schema       : " << usage.schema << "\n"
+              << "    names        : " << usage.names << "\n"
+              << "    descriptions : " << usage.descriptions << "\n"
+              << "    values       : " << usage.values << "\n"
+              << "    indices      : " << usage.indices << "\n"
+              << "    total        : " << usage.total() << "\n";
+
+    if ((usage.schema == 0) || (usage.descriptions == 0) || (usage.indices == 0)) {
+        std::cerr << "The memory usage report is missing some categories.\n";
+        return 1;
+    }
+    if (usage.total() > num_options * BYTES_PER_OPTION_BUDGET) {
+        std::cerr << "The footprint exceeds the budget of " << BYTES_PER_OPTION_BUDGET << " bytes per option.\n";
+        return 1;
+    }
+    return 0;
+}
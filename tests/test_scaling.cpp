@@ -0,0 +1,96 @@
+#include "cmdlp/parser.hpp"
+
+#include <chrono>
+
+/// @brief Builds the command line repeating each option a few times.
+/// @param num_options The number of registered options.
+/// @param num_repeats How many times each option appears on the command line.
+/// @return The arguments, program name included.
+static std::vector<std::string> make_arguments(std::size_t num_options, std::size_t num_repeats)
+{
+    std::vector<std::string> arguments(1, "test_scaling");
+    for (std::size_t r = 0; r < num_repeats; ++r) {
+        for (std::size_t i = 0; i < num_options; ++i) {
+            arguments.push_back("--option" + std::to_string(i));
+            arguments.push_back(std::to_string(i));
+        }
+    }
+    return arguments;
+}
+
+/// @brief Times a single registration and parse of the given options.
+/// @param num_options The number of registered options.
+/// @param argv The arguments, program name included.
+/// @return The time taken, in microseconds.
+static double time_once(std::size_t num_options, std::vector<char *> &argv)
+{
+    auto start = std::chrono::steady_clock::now();
+    cmdlp::Parser parser(static_cast<int>(argv.size()), argv.data());
+    for (std::size_t i = 0; i < num_options; ++i) {
+        parser.addOption("-o" + std::to_string(i), "--option" + std::to_string(i), "An option", 0, false);
+    }
+    parser.parseOptions();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// @brief Measures the time needed to register and parse a small and a large input.
+/// @param num_options The number of registered options, for the small and the large input.
+/// @param num_repeats How many times each option appears on the command line, for the small and the large input.
+/// @param small The best time of the small input, in microseconds.
+/// @param large The best time of the large input, in microseconds.
+/// @details The two inputs are timed alternately, so that a burst of load
+/// on the machine slows both down, and the best of many runs is kept.
+static void measure(const std::size_t (&num_options)[2], const std::size_t (&num_repeats)[2], double &small, double &large)
+{
+    std::vector<std::string> arguments[2];
+    std::vector<char *> argv[2];
+    for (int k = 0; k < 2; ++k) {
+        arguments[k] = make_arguments(num_options[k], num_repeats[k]);
+        for (std::string &argument : arguments[k]) {
+            argv[k].push_back(&argument[0]);
+        }
+    }
+    double best[2] = { 0, 0 };
+    for (int run = 0; run < 15; ++run) {
+        for (int k = 0; k < 2; ++k) {
+            double elapsed = time_once(num_options[k], argv[k]);
+            if ((run == 0) || (elapsed < best[k])) {
+                best[k] = elapsed;
+            }
+        }
+    }
+    small = best[0];
+    large = best[1];
+}
+
+/// @brief Checks that growing the input by `factor` grows the time roughly linearly.
+/// @param what A description of what is being grown.
+/// @param num_options The number of registered options, for the small and the large input.
+/// @param num_repeats How many times each option appears on the command line, for the small and the large input.
+/// @param factor How much larger the large input is.
+/// @return 0 on success, 1 on failure.
+/// @details A quadratic algorithm would grow by `factor * factor`, while noise
+/// rarely survives a few attempts, so the check passes as soon as one attempt does.
+static int check_linear(const char *what, const std::size_t (&num_options)[2], const std::size_t (&num_repeats)[2], double factor)
+{
+    double small = 0, large = 0, ratio = 0;
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        measure(num_options, num_repeats, small, large);
+        ratio = large / small;
+        if (ratio <= factor * 3) {
+            return 0;
+        }
+    }
+    std::cerr << "Parse time grows faster than linearly with the " << what << ": "
+              << small << "us -> " << large << "us (x" << ratio << " for x" << factor << " input)\n";
+    return 1;
+}
+
+int main(int, char *[])
+{
+    const double factor = 8;
+    int result          = 0;
+    result |= check_linear("option count", { 500, 4000 }, { 1, 1 }, factor);
+    result |= check_linear("argument count", { 200, 200 }, { 10, 80 }, factor);
+    return result;
+}
@@ -0,0 +1,181 @@
+#include "cmdlp/control.hpp"
+#include "cmdlp/server.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+/// @brief Connects to a Unix socket.
+static int test_connect(const std::string &path)
+{
+    sockaddr_un address = cmdlp::detail::make_socket_address(path);
+    int fd              = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if ((fd >= 0) && (::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/// @brief Checks that live options can be listed, read and changed through the control endpoint.
+static int test_control()
+{
+    const std::string path = "/tmp/cmdlp_test_control_" + std::to_string(::getpid()) + ".sock";
+
+    std::vector<const char *> arguments = { "test_server", "--log-level", "2" };
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.addLiveOption("-l", "--log-level", "The log level", 1);
+    parser.addLiveOption("-s", "--sampling", "The sampling rate", 0.5);
+    parser.addOption("-c", "--code", "Not a live option", 0, false);
+    parser.parseOptions();
+    cmdlp::Live<int> level = parser.getLive<int>("--log-level");
+
+    cmdlp::ControlServer control(parser, path, std::chrono::milliseconds(100));
+    const std::vector<std::vector<std::string>> requests = {
+        { "list" },
+        { "set", "-l", "4" },
+        { "set", "--log-level", "high" },
+        { "set", "--code", "1" },
+        { "get", "--sampling" },
+    };
+    pid_t pid = ::fork();
+    if (pid == 0) {
+        // The requests, then a hostile client, a silent one and a last request.
+        for (std::size_t i = 0; i < requests.size() + 3; ++i) {
+            control.serveOne();
+        }
+        // The handle sees the value set through the endpoint.
+        ::_exit((level.load() == 4) ? 0 : 1);
+    }
+    std::vector<std::vector<std::string>> replies;
+    for (const auto &request : requests) {
+        replies.push_back(cmdlp::sendControl(path, request));
+    }
+    // A client announcing a huge string is dropped without allocating it.
+    const uint32_t hostile[] = { 1, 0xffffffffU };
+    int hostile_fd           = test_connect(path);
+    cmdlp::detail::write_all(hostile_fd, hostile, sizeof(hostile));
+    ::close(hostile_fd);
+    // A client that never sends its request does not block the endpoint.
+    int silent_fd = test_connect(path);
+    replies.push_back(cmdlp::sendControl(path, { "get", "--log-level" }));
+    ::close(silent_fd);
+    int status = 1;
+    ::waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0)) {
+        std::cerr << "The live handle did not see the value set through the endpoint\n";
+        return 1;
+    }
+    if ((replies[0] != std::vector<std::string>{ "ok", "--log-level int 2", "--sampling real 0.5" }) ||
+        (replies[1] != std::vector<std::string>{ "ok", "4" }) ||
+        (replies[2].front() != "error") ||
+        (replies[3].front() != "error") ||
+        (replies[4] != std::vector<std::string>{ "ok", "0.5" }) ||
+        (replies[5] != std::vector<std::string>{ "ok", "4" })) {
+        std::cerr << "The control endpoint replied unexpectedly\n";
+        return 1;
+    }
+    parser.setLiveValue("--log-level", "3");
+    if (level.load() != 3) {
+        std::cerr << "The live handle reads " << level.load() << " instead of 3\n";
+        return 1;
+    }
+    return 0;
+}
+
+/// @brief The socket of the server, removed at exit as a static `Server` would.
+static std::string server_path;
+
+/// @brief Removes the socket of the server, if run by the commands it would break the server.
+static void remove_server_socket()
+{
+    ::unlink(server_path.c_str());
+}
+
+int main(int, char *[])
+{
+    if (test_control()) {
+        return 1;
+    }
+
+    const std::string path = "/tmp/cmdlp_test_server_" + std::to_string(::getpid()) + ".sock";
+
+    std::vector<const char *> arguments = { "test_server" };
+    cmdlp::Parser parser(static_cast<int>(arguments.size()), const_cast<char **>(arguments.data()));
+    parser.addOption("-c", "--code", "The exit code of the command", 0, false);
+
+    parser.addOption("-f", "--file", "A file, relative to the working directory", std::string(), false);
+
+    // Something other than a socket is never replaced.
+    const std::string file = path + ".file";
+    std::ofstream(file) << "keep\n";
+    bool refused = false;
+    try {
+        cmdlp::Server other(parser, file);
+    } catch (const std::runtime_error &) {
+        refused = true;
+    }
+    bool kept = (::access(file.c_str(), F_OK) == 0);
+    std::remove(file.c_str());
+    if (!refused || !kept) {
+        std::cerr << "The server replaced a regular file with its socket\n";
+        return 1;
+    }
+
+    // The client runs in /tmp, with a file only visible from there.
+    const std::string relative = "cmdlp_test_server_" + std::to_string(::getpid()) + ".txt";
+    std::ofstream("/tmp/" + relative) << "client\n";
+
+    cmdlp::Server server(parser, path);
+    pid_t pid = ::fork();
+    if (pid == 0) {
+        // The server has its own directory and environment, which the command must not see.
+        ::setenv("CMDLP_TEST_SERVER_ONLY", "1", 1);
+        if (::chdir("/") < 0) {
+            ::_exit(1);
+        }
+        // The commands must not run the exit handlers of the server.
+        server_path = path;
+        std::atexit(remove_server_socket);
+        // The command returns the parsed code, plus one if the environment was
+        // forwarded, 100 if the server environment leaks and 200 if the file is
+        // not found in the directory of the client.
+        for (int i = 0; i < 2; ++i) {
+            server.serveOne([](cmdlp::Parser &p) {
+                return p.getOption<int>("--code") + (std::getenv("CMDLP_TEST_SERVER") ? 1 : 0) +
+                       (std::getenv("CMDLP_TEST_SERVER_ONLY") ? 100 : 0) +
+                       ((::access(p.getOption<std::string>("--file").c_str(), F_OK) == 0) ? 0 : 200);
+            });
+        }
+        while (::wait(nullptr) > 0) {}
+        ::_exit(0);
+    }
+
+    std::vector<const char *> client_arguments = { "test_client", "--code", "41", "--file", relative.c_str() };
+    const char *client_environment[]           = { "CMDLP_TEST_SERVER=1", nullptr };
+    char previous[4096];
+    if (!::getcwd(previous, sizeof(previous)) || (::chdir("/tmp") < 0)) {
+        return 1;
+    }
+    int status = cmdlp::forwardToServer(path, static_cast<int>(client_arguments.size()), const_cast<char **>(client_arguments.data()), const_cast<char **>(client_environment));
+    // An invalid value fails the command, without terminating the process that serves it.
+    std::vector<const char *> invalid_arguments = { "test_client", "--code", "forty-one" };
+    int invalid_status = cmdlp::forwardToServer(path, static_cast<int>(invalid_arguments.size()), const_cast<char **>(invalid_arguments.data()), const_cast<char **>(client_environment));
+    ::waitpid(pid, nullptr, 0);
+    std::remove(relative.c_str());
+    if (::chdir(previous) < 0) {
+        return 1;
+    }
+    if (status != 42) {
+        std::cerr << "The forwarded invocation returned " << status << " instead of 42\n";
+        return 1;
+    }
+    if (invalid_status != 1) {
+        std::cerr << "The invalid invocation returned " << invalid_status << " instead of 1\n";
+        return 1;
+    }
+    if (cmdlp::forwardToServer(path + ".missing", 1, const_cast<char **>(client_arguments.data())) != -1) {
+        std::cerr << "Forwarding to a missing server should fail\n";
+        return 1;
+    }
+    return 0;
+}